@@ -0,0 +1,130 @@
+#include "barrett_context.h"
+#include "limb_ops.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+
+// below this many limbs the reciprocal is a plain long division
+static const size_t RECIPROCAL_THRESHOLD = 32;
+
+// floor(B^2n / m) for an n-limb m. The reciprocal of the top h limbs, h a bit over n / 2,
+// is good to about h limbs, one Newton step x += x * (B^2n - m * x) / B^2n doubles that
+// and the remainder fixes the last few units.
+static big_integer reciprocal(big_integer const &m, size_t n) {
+    big_integer power = big_integer(1) << static_cast<int>(64 * n);
+    if (n <= RECIPROCAL_THRESHOLD) {
+        big_integer q, r;
+        divmod_abs(power, m, q, r);
+        return q;
+    }
+    size_t h = n / 2 + 2;
+    int shift = static_cast<int>(32 * (n - h));
+    big_integer x = reciprocal(m >> shift, h) << shift;
+    x += (x * (power - m * x)) >> static_cast<int>(64 * n);
+    big_integer e = power - m * x;
+    while (e < 0) {
+        --x;
+        e += m;
+    }
+    while (e >= m) {
+        ++x;
+        e -= m;
+    }
+    return x;
+}
+
+barrett_context::barrett_context(big_integer const &modulus) : m(modulus), n(modulus.size()) {
+    if (m <= 0) {
+        throw std::invalid_argument("barrett_context: modulus must be positive");
+    }
+    mu = reciprocal(m, n);
+}
+
+static void mul_any(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn) {
+    std::shared_ptr<thread_pool> pool;
+    if (std::min(an, bn) >= thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    if (an >= bn) {
+        limbs::mul(r, a, an, b, bn, pool.get());
+    } else {
+        limbs::mul(r, b, bn, a, an, pool.get());
+    }
+}
+
+void barrett_context::divmod_limbs(uint32_t const *x, size_t xn, big_integer *q, big_integer &r) const {
+    uint32_t const *md = m.data();
+    std::vector<uint32_t> rem(n + 1, 0);
+    std::copy(x, x + std::min(xn, n + 1), rem.data());
+    std::vector<uint32_t> quotient(1, 0);
+    if (xn >= n) {
+        // q = floor(floor(x / B^(n-1)) * mu / B^(n+1)) is at most 2 below the true quotient
+        size_t q1n = xn - (n - 1);
+        std::vector<uint32_t> t(q1n + mu.size());
+        mul_any(t.data(), x + n - 1, q1n, mu.data(), mu.size());
+        if (t.size() > n + 1) {
+            quotient.assign(t.begin() + (n + 1), t.end());
+            size_t qn = limbs::normalized_size(quotient.data(), quotient.size());
+            quotient.resize(qn);
+            // the remainder is below 3m, so n + 1 limbs of x - q * m are enough
+            std::vector<uint32_t> p(qn + n);
+            mul_any(p.data(), quotient.data(), qn, md, n);
+            limbs::sub_n(rem.data(), rem.data(), p.data(), n + 1);
+        }
+    }
+    uint32_t extra = 0;
+    while (rem[n] != 0 || limbs::cmp(rem.data(), md, n) >= 0) {
+        limbs::sub(rem.data(), rem.data(), n + 1, md, n);
+        extra++;
+    }
+    if (q != nullptr) {
+        quotient.push_back(0);
+        limbs::add_1(quotient.data(), quotient.data(), quotient.size(), extra);
+        q->val.resize(quotient.size());
+        std::copy(quotient.begin(), quotient.end(), q->val.data());
+        q->sign = 1;
+        q->shrink_to_fit();
+    }
+    r.val.resize(n);
+    std::copy(rem.data(), rem.data() + n, r.val.data());
+    r.sign = 1;
+    r.shrink_to_fit();
+}
+
+void barrett_context::divmod(big_integer_view x, big_integer &q, big_integer &r) const {
+    divmod_limbs(x.data(), x.size(), &q, r);
+}
+
+void barrett_context::reduce_short(big_integer &x) const {
+    divmod_limbs(x.data(), x.size(), nullptr, x);
+}
+
+big_integer barrett_context::reduce(big_integer const &x) const {
+    big_integer r = x;
+    r.sign = 1;
+    if (r.size() >= 2 * n) {
+        // Horner over n-limb chunks from the top, every step stays below m * B^n
+        size_t pos = (r.size() - 1) / n * n;
+        uint32_t const *a = x.data();
+        size_t an = r.size();
+        big_integer chunk;
+        r.val.assign(an - pos, 0);
+        std::copy(a + pos, a + an, r.val.data());
+        reduce_short(r);
+        while (pos != 0) {
+            pos -= n;
+            chunk.val.resize(n);
+            std::copy(a + pos, a + pos + n, chunk.val.data());
+            chunk.shrink_to_fit();
+            r <<= static_cast<int>(32 * n);
+            r += chunk;
+            reduce_short(r);
+        }
+    } else {
+        reduce_short(r);
+    }
+    if (x.sign < 0 && r != 0) {
+        r = m - r;
+    }
+    return r;
+}
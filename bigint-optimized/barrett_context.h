@@ -0,0 +1,43 @@
+#ifndef BARRETT_CONTEXT_H
+#define BARRETT_CONTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "big_integer.h"
+#include "big_integer_view.h"
+
+// Repeated division by a fixed m > 0 of n limbs. mu = floor(B^2n / m) is computed
+// once by Newton iteration, after that a value below m * B^n costs two products
+// and at most two corrective subtractions. Works for any modulus, odd or even.
+struct barrett_context {
+    // throws std::invalid_argument unless the modulus is positive
+    explicit barrett_context(big_integer const &modulus);
+
+    big_integer const &modulus() const {
+        return m;
+    }
+
+    // number of limbs of the modulus
+    size_t size() const {
+        return n;
+    }
+
+    // q = |x| / m and r = |x| % m for |x| < m * B^n; q or r may hold the limbs of x
+    void divmod(big_integer_view x, big_integer &q, big_integer &r) const;
+
+    // x mod m in [0, m) for any x, longer values are folded n limbs at a time
+    big_integer reduce(big_integer const &x) const;
+
+private:
+    // q and r of x < m * B^n given as xn limbs, q may be null
+    void divmod_limbs(uint32_t const *x, size_t xn, big_integer *q, big_integer &r) const;
+
+    // x < m * B^n in, x mod m out
+    void reduce_short(big_integer &x) const;
+
+    big_integer m;
+    size_t n;
+    big_integer mu;
+};
+
+#endif //BARRETT_CONTEXT_H
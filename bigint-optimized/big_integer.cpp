@@ -3,11 +3,77 @@
 //
 
 #include "big_integer.h"
+#include "barrett_context.h"
+#include "big_integer_impl.h"
+#include "big_integer_stats.h"
+#include "big_integer_view.h"
+#include "limb_ops.h"
+#include "thread_pool.h"
 #include <climits>
+#include <deque>
+#include <mutex>
 #include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 static const uint32_t MAX_DEG = 32;
+static const uint32_t DECIMAL_BASE = 1000000000;
+static const size_t DECIMAL_DIGITS = 9;
+static const size_t DECIMAL_THRESHOLD = 48;
+// from this many limbs in the shorter factor addmul goes through a product buffer
+static const size_t ADDMUL_ROWS_THRESHOLD = 32;
+
+namespace {
+    struct decimal_power {
+        big_integer value;
+        std::unique_ptr<barrett_context> divisor;
+    };
+
+    std::mutex decimal_powers_lock;
+    // a deque never moves its elements, references handed out stay valid
+    std::deque<decimal_power> decimal_powers;
+
+    // 10^(9 * 2^k), computed once per process and shared by all conversions
+    // the products may run on the pool, so they are made unlocked and only published under the lock
+    decimal_power const &get_decimal_power(size_t k, bool with_divisor) {
+        std::unique_lock<std::mutex> guard(decimal_powers_lock);
+        if (decimal_powers.empty()) {
+            decimal_powers.emplace_back();
+            decimal_powers.back().value = DECIMAL_BASE;
+        }
+        while (decimal_powers.size() <= k) {
+            size_t index = decimal_powers.size();
+            big_integer const &last = decimal_powers.back().value;
+            guard.unlock();
+            big_integer next = last * last;
+            guard.lock();
+            if (decimal_powers.size() == index) {
+                decimal_powers.emplace_back();
+                decimal_powers.back().value = next;
+            }
+        }
+        decimal_power &power = decimal_powers[k];
+        if (with_divisor && !power.divisor) {
+            guard.unlock();
+            std::unique_ptr<barrett_context> divisor(new barrett_context(power.value));
+            guard.lock();
+            if (!power.divisor) {
+                power.divisor = std::move(divisor);
+            }
+        }
+        return power;
+    }
+}
+
+big_integer read_decimal(char const *str, size_t len, thread_pool *pool);
+
+big_integer parse_decimal(char const *str, size_t len) {
+    std::shared_ptr<thread_pool> pool;
+    if (len / DECIMAL_DIGITS >= thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    return read_decimal(str, len, pool.get());
+}
 
 big_integer::big_integer(int value) : sign(value >= 0 ? 1 : -1) {
     uint32_t tmp;
@@ -27,7 +93,12 @@ big_integer::big_integer(uint32_t value) : val(uint_vector(1, value)), sign(1) {
 
 big_integer::big_integer() : val(uint_vector(1, 0)), sign(1) {}
 
+big_integer::big_integer(big_integer_view a) : val(uint_vector(std::max<size_t>(1, a.size()), 0)), sign(a.sign()) {
+    std::copy(a.data(), a.data() + a.size(), val.data());
+}
+
 big_integer::big_integer(const std::string &str) : big_integer() {
+    BIGINT_STATS_CALL(PARSE, str.size() / DECIMAL_DIGITS + 1);
     if (str == "0" || str.empty()) {
         return;
     }
@@ -41,14 +112,81 @@ big_integer::big_integer(const std::string &str) : big_integer() {
         tsign = 1;
         i = 1;
     }
-    for (; i < str.size(); i++) {
-        if (!(str[i] >= '0' && str[i] <= '9')) {
-            throw std::invalid_argument("expected digit, found not digit at pos:" + std::to_string(i));
+    for (size_t j = i; j < str.size(); j++) {
+        if (!(str[j] >= '0' && str[j] <= '9')) {
+            throw std::invalid_argument("expected digit, found not digit at pos:" + std::to_string(j));
         }
-        *this *= 10;
-        *this += str[i] - '0';
     }
-    sign = tsign;
+    big_integer res = parse_decimal(str.data() + i, str.size() - i);
+    swap(res);
+    if (!(size() == 1 && val[0] == 0)) {
+        sign = tsign;
+    }
+}
+
+// the low 9 * 2^k digits go below 10^(9 * 2^k), both halves are independent
+big_integer read_decimal(char const *str, size_t len, thread_pool *pool) {
+    if (len <= DECIMAL_THRESHOLD * DECIMAL_DIGITS) {
+        big_integer res;
+        size_t chunk = len % DECIMAL_DIGITS;
+        if (chunk == 0) {
+            chunk = DECIMAL_DIGITS;
+        }
+        for (size_t i = 0; i < len; i += chunk, chunk = DECIMAL_DIGITS) {
+            uint32_t digits = 0;
+            uint32_t scale = 1;
+            for (size_t j = i; j < i + chunk; j++) {
+                digits = digits * 10 + (str[j] - '0');
+                scale *= 10;
+            }
+            res.mul_add_short(scale, digits);
+        }
+        res.shrink_to_fit();
+        return res;
+    }
+    size_t k = 0;
+    while ((DECIMAL_DIGITS << (k + 1)) < len) {
+        k++;
+    }
+    size_t low_len = DECIMAL_DIGITS << k;
+    big_integer high, low;
+    if (pool != nullptr && len / DECIMAL_DIGITS >= thread_pool::parallel_cutoff()) {
+        thread_pool::task_group group(pool);
+        group.spawn([&] { low = read_decimal(str + len - low_len, low_len, pool); });
+        high = read_decimal(str, len - low_len, pool);
+        group.wait();
+    } else {
+        high = read_decimal(str, len - low_len, pool);
+        low = read_decimal(str + len - low_len, low_len, pool);
+    }
+    high *= get_decimal_power(k, false).value;
+    high += low;
+    return high;
+}
+
+void big_integer::mul_add_short(uint32_t mul, uint32_t add) {
+    uint32_t *data = val.data();
+    uint64_t carry = add;
+    for (size_t i = 0; i < size(); i++) {
+        uint64_t cur = static_cast<uint64_t>(data[i]) * mul + carry;
+        data[i] = static_cast<uint32_t>(cur);
+        carry = cur >> MAX_DEG;
+    }
+    if (carry != 0) {
+        val.push_back(static_cast<uint32_t>(carry));
+    }
+}
+
+uint32_t big_integer::div_decimal_base() {
+    uint32_t *data = val.data();
+    uint64_t rem = 0;
+    for (size_t i = size(); i-- > 0;) {
+        uint64_t cur = (rem << MAX_DEG) | data[i];
+        data[i] = static_cast<uint32_t>(cur / DECIMAL_BASE);
+        rem = cur % DECIMAL_BASE;
+    }
+    shrink_to_fit();
+    return static_cast<uint32_t>(rem);
 }
 
 big_integer &big_integer::operator=(const big_integer &other) {
@@ -61,6 +199,7 @@ big_integer &big_integer::operator=(const big_integer &other) {
 }
 
 big_integer &big_integer::operator+=(const big_integer &other) {
+    BIGINT_STATS_CALL(ADD, std::max(size(), other.size()));
     if (sign == other.sign) {
         big_integer res;
         res.val.assign(std::max(size(), other.size()) + 1, 0);
@@ -88,6 +227,7 @@ big_integer &big_integer::operator+=(const big_integer &other) {
 }
 
 big_integer &big_integer::operator-=(const big_integer &other) {
+    BIGINT_STATS_CALL(SUB, std::max(size(), other.size()));
     if (other.sign == 1 || other == 0) {
         if (*this < other) {
             *this = (other - *this);
@@ -132,72 +272,157 @@ big_integer big_integer::operator+() const {
 }
 
 big_integer &big_integer::operator*=(const big_integer &other) {
-    if (*this == 0 || other == 0) {
-        *this = 0;
-    }
+    BIGINT_STATS_CALL(MUL, std::max(size(), other.size()));
     big_integer res;
     res.val.assign(size() + other.size(), 0);
-    for (size_t i = 0; i < size(); i++) {
-        uint32_t cur = 0;
-        for (size_t j = 0; j < other.size(); j++) {
-            uint64_t temp = static_cast<uint64_t>(val[i]) * other.val[j] + res.val[i + j] + cur;
-            res.val[i + j] = static_cast<uint32_t> (temp);
-            cur = static_cast<uint32_t> (temp >> MAX_DEG);
-        }
-        res.val[i + other.size()] += cur;
+    std::shared_ptr<thread_pool> pool;
+    if (std::min(size(), other.size()) >= thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    uint32_t const *a = data();
+    uint32_t const *b = other.data();
+    if (a == b && size() == other.size()) {
+        limbs::sqr(res.val.data(), a, size(), pool.get());
+    } else if (size() >= other.size()) {
+        limbs::mul(res.val.data(), a, size(), b, other.size(), pool.get());
+    } else {
+        limbs::mul(res.val.data(), b, other.size(), a, size(), pool.get());
     }
     res.sign = sign * other.sign;
     res.shrink_to_fit();
-    *this = res;
+    if (res.size() == 1 && res.val[0] == 0) {
+        res.sign = 1;
+    }
+    swap(res);
     return *this;
 }
 
-void big_integer::shrink_to_fit() {
-    while (size() > 1 && val.back() == 0) {
-        val.pop_back();
+void big_integer::add_product(uint32_t const *x, size_t xn, uint32_t const *y, size_t yn, int s) {
+    if (xn < yn) {
+        std::swap(x, y);
+        std::swap(xn, yn);
+    }
+    if ((xn == 1 && x[0] == 0) || (yn == 1 && y[0] == 0)) {
+        return;
+    }
+    if (size() == 1 && val[0] == 0) {
+        sign = s;
+    }
+    size_t n = std::max(size(), xn + yn) + 1;
+    val.resize(n);
+    uint32_t *a = val.data();
+    std::vector<uint32_t> p;
+    if (yn >= ADDMUL_ROWS_THRESHOLD) {
+        std::shared_ptr<thread_pool> pool;
+        if (yn >= thread_pool::parallel_cutoff()) {
+            pool = thread_pool::instance();
+        }
+        p.resize(xn + yn);
+        limbs::mul(p.data(), x, xn, y, yn, pool.get());
+    }
+    if (sign == s) {
+        if (p.empty()) {
+            for (size_t j = 0; j < yn; j++) {
+                uint32_t carry = limbs::addmul_1(a + j, x, xn, y[j]);
+                limbs::add_1(a + j + xn, a + j + xn, n - j - xn, carry);
+            }
+        } else {
+            limbs::add(a, a, n, p.data(), p.size());
+        }
+    } else {
+        // the partial results only decrease, so they wrap around at most once
+        uint32_t borrow = 0;
+        if (p.empty()) {
+            for (size_t j = 0; j < yn; j++) {
+                uint32_t high = limbs::submul_1(a + j, x, xn, y[j]);
+                borrow |= limbs::sub_1(a + j + xn, a + j + xn, n - j - xn, high);
+            }
+        } else {
+            borrow = limbs::sub(a, a, n, p.data(), p.size());
+        }
+        if (borrow != 0) {
+            // n limb two's complement back to the magnitude
+            for (size_t i = 0; i < n; i++) {
+                a[i] = ~a[i];
+            }
+            limbs::add_1(a, a, n, 1);
+            sign = -sign;
+        }
+    }
+    shrink_to_fit();
+    if (size() == 1 && val[0] == 0) {
+        sign = 1;
     }
 }
 
-void big_integer::swap(big_integer &other) {
-    std::swap(val, other.val);
-    std::swap(sign, other.sign);
+// x itself, or a copy of it when it is acc: the copy shares the limbs and keeps them intact while acc is written
+static big_integer const &stable(big_integer const &acc, big_integer const &x, big_integer &copy) {
+    if (&acc != &x) {
+        return x;
+    }
+    copy = x;
+    return copy;
 }
 
-bool operator==(const big_integer &a, const big_integer &b) {
-    if (a.sign == b.sign) {
-        return a.val == b.val;
-    } else {
-        return a.size() == 1 && a.val[0] == 0 && b.size() == 1 && b.val[0] == 0;
-    }
+void addmul(big_integer &acc, big_integer const &x, big_integer const &y) {
+    BIGINT_STATS_CALL(MUL, std::max(x.size(), y.size()));
+    big_integer cx, cy;
+    big_integer const &fx = stable(acc, x, cx), &fy = stable(acc, y, cy);
+    acc.add_product(fx.data(), fx.size(), fy.data(), fy.size(), x.sign * y.sign);
 }
 
-uint32_t trial(big_integer const &a, big_integer const &b) {
-    uint128_t t1 =
-            (static_cast<uint128_t>(a.val[a.size() - 1]) << (MAX_DEG * 2)) + (static_cast<uint128_t>(a.val[a.size() - 2]) << MAX_DEG) +
-            static_cast<uint128_t>(a.val[a.size() - 3]);
-    uint128_t t2 = (static_cast<uint128_t>(b.val[b.size() - 1]) << MAX_DEG) + b.val[b.size() - 2];
-    return static_cast<uint32_t>(t1 / t2);
+void submul(big_integer &acc, big_integer const &x, big_integer const &y) {
+    BIGINT_STATS_CALL(MUL, std::max(x.size(), y.size()));
+    big_integer cx, cy;
+    big_integer const &fx = stable(acc, x, cx), &fy = stable(acc, y, cy);
+    acc.add_product(fx.data(), fx.size(), fy.data(), fy.size(), -x.sign * y.sign);
 }
 
-bool smaller(big_integer const &a, big_integer const &b, uint32_t k) {
-    for (size_t i = 1; i <= a.size(); i++) {
-        uint32_t tmp = k - i < b.size() ? b.val[k - i] : 0;
-        if (a.val[a.size() - i] != tmp) {
-            return a.val[a.size() - i] < tmp;
-        }
-    }
-    return false;
+void addmul(big_integer &acc, big_integer const &x, uint32_t y) {
+    BIGINT_STATS_CALL(MUL, x.size());
+    big_integer cx;
+    big_integer const &fx = stable(acc, x, cx);
+    acc.add_product(fx.data(), fx.size(), &y, 1, x.sign);
+}
+
+void submul(big_integer &acc, big_integer const &x, uint32_t y) {
+    BIGINT_STATS_CALL(MUL, x.size());
+    big_integer cx;
+    big_integer const &fx = stable(acc, x, cx);
+    acc.add_product(fx.data(), fx.size(), &y, 1, -x.sign);
+}
+
+void addmul(big_integer &acc, big_integer const &x, int y) {
+    BIGINT_STATS_CALL(MUL, x.size());
+    big_integer cx;
+    big_integer const &fx = stable(acc, x, cx);
+    uint32_t magnitude = y < 0 ? 0u - static_cast<uint32_t>(y) : static_cast<uint32_t>(y);
+    acc.add_product(fx.data(), fx.size(), &magnitude, 1, y < 0 ? -x.sign : x.sign);
+}
+
+void submul(big_integer &acc, big_integer const &x, int y) {
+    BIGINT_STATS_CALL(MUL, x.size());
+    big_integer cx;
+    big_integer const &fx = stable(acc, x, cx);
+    uint32_t magnitude = y < 0 ? 0u - static_cast<uint32_t>(y) : static_cast<uint32_t>(y);
+    acc.add_product(fx.data(), fx.size(), &magnitude, 1, y < 0 ? x.sign : -x.sign);
 }
 
-void difference(big_integer &a, big_integer const &b, size_t k) {
-    int borrow = 0;
-    for (size_t i = 0; i < a.size() - k; i++) {
-        uint32_t diff = a.val[i + k] - (i < b.size() ? b.val[i] : 0) - borrow;
-        borrow = ((i < b.size() ? b.val[i] : 0) + borrow > a.val[i + k]);
-        a.val[i + k] = static_cast<uint32_t> (diff);
+void big_integer::shrink_to_fit() {
+    while (size() > 1 && val.back() == 0) {
+        val.pop_back();
     }
 }
 
+void big_integer::swap(big_integer &other) {
+    std::swap(val, other.val);
+    std::swap(sign, other.sign);
+}
+
+bool operator==(const big_integer &a, const big_integer &b) {
+    return compare(a, b) == 0;
+}
+
 big_integer div_bi_short(big_integer &a, uint32_t b) {
     if (b == 0) {
         throw std::runtime_error("found divide by zero");
@@ -215,45 +440,34 @@ big_integer div_bi_short(big_integer &a, uint32_t b) {
     return ans;
 }
 
-big_integer &big_integer::operator/=(const big_integer &other) {
-    int ans_sign = sign * other.sign;
-    int tmp = sign;
-    sign = other.sign;
-    if ((sign == 1 && *this < other) || (sign == -1 && *this > other)) {
-        *this = 0;
-        return *this;
+void divmod_abs(big_integer const &a, big_integer const &b, big_integer &q, big_integer &r) {
+    if (a.size() < b.size()) {
+        r = a;
+        r.sign = 1;
+        q = 0;
+        return;
     }
-    sign = tmp;
-    big_integer a = *this;
-    big_integer b = other;
-    big_integer x;
-    a.sign = 1;
-    b.sign = 1;
-    if (b.size() == 1) {
-        x = div_bi_short(a, b.val[0]);
-        x.sign = ans_sign;
-        *this = x;
-        return *this;
+    big_integer quotient, remainder;
+    quotient.val.assign(a.size() - b.size() + 1, 0);
+    remainder.val.assign(b.size(), 0);
+    limbs::divrem(quotient.val.data(), remainder.val.data(), a.data(), a.size(), b.data(), b.size());
+    quotient.shrink_to_fit();
+    remainder.shrink_to_fit();
+    q.swap(quotient);
+    r.swap(remainder);
+}
+
+big_integer &big_integer::operator/=(const big_integer &other) {
+    BIGINT_STATS_CALL(DIV, std::max(size(), other.size()));
+    if (other == 0) {
+        throw std::runtime_error("found divide by zero");
     }
-    a.val.push_back(0);
-    size_t n = a.size();
-    size_t m = b.size() + 1;
-    x.val.assign(n - m + 2, 0);
-    for (size_t k = n - m + 1; k != 0; k--) {
-        uint32_t qt = trial(a, b);
-        big_integer dq = b * qt;
-        dq.val.push_back(0);
-        if (smaller(a, dq, m)) {
-            qt--;
-            dq -= b;
-        }
-        x.val[k - 1] = qt;
-        difference(a, dq, a.size() - m);
-        if (!a.val.back()) a.val.pop_back();
+    big_integer q, r;
+    divmod_abs(*this, other, q, r);
+    if (q != 0) {
+        q.sign = sign * other.sign;
     }
-    x.shrink_to_fit();
-    x.sign = ans_sign;
-    *this = x;
+    swap(q);
     return *this;
 }
 
@@ -281,42 +495,36 @@ big_integer operator/(big_integer a, const big_integer &b) {
 }
 
 big_integer operator%(big_integer a, const big_integer &b) {
-    return a - ((a / b) * b);
+    BIGINT_STATS_CALL(MOD, std::max(a.size(), b.size()));
+    if (b == 0) {
+        throw std::runtime_error("found divide by zero");
+    }
+    big_integer q, r;
+    divmod_abs(a, b, q, r);
+    if (r != 0) {
+        r.sign = a.sign;
+    }
+    return r;
 }
 
 bool operator!=(const big_integer &a, const big_integer &b) {
-    return !(a == b);
+    return compare(a, b) != 0;
 }
 
 bool operator<(const big_integer &a, const big_integer &b) {
-    if (a.sign != b.sign) {
-        return a.sign < 0;
-    }
-    if (a.sign == -1) {
-        return -a > -b;
-    }
-    if (a.size() != b.size()) {
-        return a.size() < b.size();
-    }
-    size_t i = a.size();
-    while (i--) {
-        if (a.val[i] != b.val[i]) {
-            return a.val[i] < b.val[i];
-        }
-    }
-    return false;
+    return compare(a, b) < 0;
 }
 
 bool operator>(const big_integer &a, const big_integer &b) {
-    return b < a;
+    return compare(a, b) > 0;
 }
 
 bool operator<=(const big_integer &a, const big_integer &b) {
-    return a < b || a == b;
+    return compare(a, b) <= 0;
 }
 
 bool operator>=(const big_integer &a, const big_integer &b) {
-    return a > b || a == b;
+    return compare(a, b) >= 0;
 }
 
 big_integer big_integer::operator~() const {
@@ -397,6 +605,7 @@ void big_integer::add_up(size_t n) {
 }
 
 big_integer &big_integer::operator>>=(int value) {
+    BIGINT_STATS_CALL(SHR, size());
     if (value < 0) {
         *this = *this << -value;
         return *this;
@@ -414,6 +623,7 @@ big_integer &big_integer::operator>>=(int value) {
 }
 
 big_integer &big_integer::operator<<=(int value) {
+    BIGINT_STATS_CALL(SHL, size());
     if (value < 0) {
         *this = *this >> -value;
         return *this;
@@ -428,16 +638,19 @@ big_integer &big_integer::operator<<=(int value) {
 }
 
 big_integer &big_integer::operator&=(const big_integer &other) {
+    BIGINT_STATS_CALL(AND, std::max(size(), other.size()));
     *this = b_op(*this, other, b_and);
     return *this;
 }
 
 big_integer &big_integer::operator|=(const big_integer &other) {
+    BIGINT_STATS_CALL(OR, std::max(size(), other.size()));
     *this = b_op(*this, other, b_or);
     return *this;
 }
 
 big_integer &big_integer::operator^=(const big_integer &other) {
+    BIGINT_STATS_CALL(XOR, std::max(size(), other.size()));
     *this = b_op(*this, other, b_xor);
     return *this;
 }
@@ -458,8 +671,7 @@ big_integer operator^(big_integer a, const big_integer &b) {
 }
 
 std::ostream &operator<<(std::ostream &os, big_integer const &other) {
-    os << to_string(other);
-    return os;
+    return os << big_integer_view(other);
 }
 
 big_integer operator>>(big_integer a, int value) {
@@ -472,17 +684,108 @@ big_integer operator<<(big_integer a, int value) {
     return a;
 }
 
+// writes exactly 9 * 2^k digits of a < 10^(9 * 2^k), the slice is zero-filled beforehand
+void write_decimal(big_integer const &a, char *out, size_t k, thread_pool *pool) {
+    if (k == 0 || a.size() <= DECIMAL_THRESHOLD) {
+        big_integer tmp = a;
+        char *pos = out + (DECIMAL_DIGITS << k);
+        while (tmp != 0) {
+            uint32_t digits = tmp.div_decimal_base();
+            for (size_t i = 0; i < DECIMAL_DIGITS; i++) {
+                *--pos = char('0' + digits % 10);
+                digits /= 10;
+            }
+        }
+        return;
+    }
+    big_integer high, low;
+    get_decimal_power(k - 1, true).divisor->divmod(a, high, low);
+    char *middle = out + (DECIMAL_DIGITS << (k - 1));
+    if (pool != nullptr && a.size() >= thread_pool::parallel_cutoff()) {
+        thread_pool::task_group group(pool);
+        group.spawn([&] { write_decimal(low, middle, k - 1, pool); });
+        write_decimal(high, out, k - 1, pool);
+        group.wait();
+    } else {
+        write_decimal(high, out, k - 1, pool);
+        write_decimal(low, middle, k - 1, pool);
+    }
+}
+
 std::string to_string(const big_integer &a) {
-    if (a == 0) {
-        return "0";
+    return to_string(big_integer_view(a));
+}
+
+namespace {
+    // the decimal digits of a short |a| != 0 into [first, last), divided down in a copy on the stack
+    char *write_short_decimal(big_integer_view a, char *first, char *last) {
+        // 1e9 takes at least 29 bits a step
+        uint32_t tmp[DECIMAL_THRESHOLD];
+        char buf[DECIMAL_DIGITS * (DECIMAL_THRESHOLD * MAX_DEG / 29 + 1)];
+        size_t n = a.size();
+        std::copy(a.data(), a.data() + n, tmp);
+        char *end = buf + sizeof(buf);
+        char *pos = end;
+        while (n > 1 || tmp[0] != 0) {
+            uint32_t digits = limbs::divrem_1(tmp, tmp, n, DECIMAL_BASE);
+            n = limbs::normalized_size(tmp, n);
+            for (size_t i = 0; i < DECIMAL_DIGITS; i++) {
+                *--pos = char('0' + digits % 10);
+                digits /= 10;
+            }
+        }
+        while (*pos == '0') {
+            pos++;
+        }
+        if (end - pos > last - first) {
+            return nullptr;
+        }
+        return std::copy(pos, end, first);
     }
-    std::string ans;
-    big_integer tmp = a;
-    while (tmp != 0) {
-        ans += char('0' + (tmp % 10).val[0]);
-        tmp /= 10;
+}
+
+char *write_decimal_chars(big_integer_view a, char *first, char *last) {
+    if (a.size() <= DECIMAL_THRESHOLD) {
+        return write_short_decimal(a, first, last);
     }
-    if (a.sign == -1) ans += '-';
-    reverse(ans.begin(), ans.end());
-    return ans;
-}
\ No newline at end of file
+    // split the top off until it is short: top = high * 10^(9 * 2^k) + low with high < 10^(9 * 2^k),
+    // so every low is a chunk of exactly 9 * 2^k digits and only the final top is written unpadded
+    std::vector<std::pair<big_integer, size_t>> chunks;
+    big_integer high;
+    big_integer_view top(1, a.data(), a.size());
+    while (top.size() > DECIMAL_THRESHOLD) {
+        size_t k = 1;
+        while (get_decimal_power(k, false).value <= top) {
+            k++;
+        }
+        big_integer low;
+        get_decimal_power(k - 1, true).divisor->divmod(top, high, low);
+        chunks.emplace_back(low, k - 1);
+        top = high;
+    }
+    char *pos = write_short_decimal(top, first, last);
+    if (pos == nullptr) {
+        return nullptr;
+    }
+    size_t length = 0;
+    for (auto const &chunk : chunks) {
+        length += DECIMAL_DIGITS << chunk.second;
+    }
+    if (length > static_cast<size_t>(last - pos)) {
+        return nullptr;
+    }
+    std::fill(pos, pos + length, '0');
+    std::shared_ptr<thread_pool> pool;
+    if (a.size() >= thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    thread_pool::task_group group(pool.get());
+    for (size_t i = chunks.size(); i-- > 0;) {
+        char *out = pos;
+        pos += DECIMAL_DIGITS << chunks[i].second;
+        thread_pool *p = pool.get();
+        group.spawn([&chunks, i, out, p] { write_decimal(chunks[i].first, out, chunks[i].second, p); });
+    }
+    group.wait();
+    return pos;
+}
@@ -9,9 +9,22 @@
 #include <string>
 #include "uint_vector.h"
 #include <algorithm>
+#include <vector>
 
+__extension__ typedef __int128 int128_t;
 __extension__ typedef unsigned __int128 uint128_t;
 
+struct thread_pool;
+
+struct big_integer_view;
+
+enum class byte_order;
+
+enum class byte_format;
+
+template<typename E>
+struct big_integer_expr;
+
 struct big_integer {
     big_integer();
 
@@ -23,10 +36,26 @@ struct big_integer {
 
     explicit big_integer(std::string const &str);
 
+    // copies the limbs of the view, see big_integer_view.h
+    explicit big_integer(big_integer_view a);
+
+    // expression templates are evaluated straight into the value, see big_integer_expr.h
+    template<typename E>
+    big_integer(big_integer_expr<E> const &e);
+
     ~big_integer() = default;
 
     big_integer &operator=(big_integer const &other);
 
+    template<typename E>
+    big_integer &operator=(big_integer_expr<E> const &e);
+
+    template<typename E>
+    big_integer &operator+=(big_integer_expr<E> const &e);
+
+    template<typename E>
+    big_integer &operator-=(big_integer_expr<E> const &e);
+
     big_integer &operator+=(big_integer const &other);
 
     big_integer &operator-=(big_integer const &other);
@@ -79,19 +108,53 @@ struct big_integer {
 
     friend std::string to_string(big_integer const& a);
 
+    friend big_integer operator%(big_integer a, big_integer const &b);
+
+    friend big_integer pow_mod(big_integer const &base, big_integer const &exp, big_integer const &mod);
+
+    friend big_integer pow(big_integer const &base, uint64_t exp);
+
+    friend size_t bit_length(big_integer const &a);
+
+    friend bool is_probable_prime(big_integer const &a);
+
+    friend big_integer fibonacci(uint64_t n);
+
+    friend big_integer lucas(uint64_t n);
+
+    friend big_integer from_bytes(uint8_t const *data, size_t n, byte_order order, byte_format format);
+
+    friend std::vector<big_integer> remainders(big_integer const &x, std::vector<big_integer> const &moduli);
+
+    friend void addmul(big_integer &acc, big_integer const &x, big_integer const &y);
+
+    friend void submul(big_integer &acc, big_integer const &x, big_integer const &y);
+
+    friend void addmul(big_integer &acc, big_integer const &x, uint32_t y);
+
+    friend void submul(big_integer &acc, big_integer const &x, uint32_t y);
+
+    friend void addmul(big_integer &acc, big_integer const &x, int y);
+
+    friend void submul(big_integer &acc, big_integer const &x, int y);
+
 private:
 
-    void swap(big_integer &other);
+    friend struct montgomery_context;
 
-    void shrink_to_fit();
+    friend struct barrett_context;
 
-    friend uint32_t trial(big_integer const &, big_integer const &);
+    friend struct big_integer_eval;
 
-    friend void difference(big_integer &, big_integer const &, size_t);
+    friend struct big_integer_accumulator;
 
-    friend big_integer div_bi_short(big_integer &, uint32_t);
+    friend struct big_integer_view;
+
+    void swap(big_integer &other);
 
-    friend bool smaller(big_integer const &, big_integer const &, uint32_t);
+    void shrink_to_fit();
+
+    friend big_integer div_bi_short(big_integer &, uint32_t);
 
     friend big_integer b_op(big_integer const &, big_integer const &, uint32_t (*f)(uint32_t, uint32_t));
 
@@ -99,10 +162,27 @@ private:
 
     void add_up(size_t);
 
+    friend void divmod_abs(big_integer const &, big_integer const &, big_integer &, big_integer &);
+
+    friend void write_decimal(big_integer const &, char *, size_t, thread_pool *);
+
+    friend big_integer read_decimal(char const *, size_t, thread_pool *);
+
+    void mul_add_short(uint32_t, uint32_t);
+
+    // this += s * |x| * |y| in the limbs of this, neither operand may point into them
+    void add_product(uint32_t const *x, size_t xn, uint32_t const *y, size_t yn, int s);
+
+    uint32_t div_decimal_base();
+
     size_t size() const {
         return val.size();
     }
 
+    uint32_t const *data() const {
+        return val.data();
+    }
+
 private:
     uint_vector val;
     int sign;
@@ -124,6 +204,25 @@ big_integer operator|(big_integer a, big_integer const &b);
 
 big_integer operator^(big_integer a, big_integer const &b);
 
+// acc += x * y and acc -= x * y straight into the limbs of acc: short operands go row by
+// row through the addmul_1 / submul_1 kernels, long ones through one product buffer
+void addmul(big_integer &acc, big_integer const &x, big_integer const &y);
+
+void submul(big_integer &acc, big_integer const &x, big_integer const &y);
+
+void addmul(big_integer &acc, big_integer const &x, uint32_t y);
+
+void submul(big_integer &acc, big_integer const &x, uint32_t y);
+
+// a negative y counts with its sign, not as its 32 bit two's complement
+void addmul(big_integer &acc, big_integer const &x, int y);
+
+void submul(big_integer &acc, big_integer const &x, int y);
+
 std::ostream &operator<<(std::ostream &os, big_integer const &other);
 
+// an optional sign and the digits in the base of the stream's basefield, read in fixed chunks
+// and assembled divide-and-conquer, see big_integer_radix.cpp; failbit and x unchanged without digits
+std::istream &operator>>(std::istream &is, big_integer &x);
+
 #endif //BIG_INTEGER_H
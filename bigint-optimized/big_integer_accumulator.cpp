@@ -0,0 +1,122 @@
+#include "big_integer_accumulator.h"
+#include "limb_ops.h"
+#include "thread_pool.h"
+#include <algorithm>
+
+// a 64-bit partial sum takes this many contributions below 2^32 without overflow
+static const uint64_t MAX_LOAD = uint64_t(1) << 32;
+// from this many limbs in the shorter factor a product is formed first and added as one term
+static const size_t ROWS_THRESHOLD = 32;
+
+big_integer_accumulator::big_integer_accumulator() {
+    clear();
+}
+
+void big_integer_accumulator::clear() {
+    pos.limbs.assign(1, 0);
+    pos.load = 0;
+    neg.limbs.assign(1, 0);
+    neg.load = 0;
+}
+
+big_integer_accumulator::sums &big_integer_accumulator::side(int sign) {
+    return sign > 0 ? pos : neg;
+}
+
+void big_integer_accumulator::sums::reserve(size_t n, uint64_t contributions) {
+    if (load + contributions > MAX_LOAD) {
+        carry();
+    }
+    load += contributions;
+    if (limbs.size() < n) {
+        limbs.resize(n, 0);
+    }
+}
+
+void big_integer_accumulator::sums::add(uint32_t const *x, size_t n) {
+    reserve(n, 1);
+    uint64_t *s = limbs.data();
+    for (size_t i = 0; i < n; i++) {
+        s[i] += x[i];
+    }
+}
+
+void big_integer_accumulator::sums::add_product(uint32_t const *x, size_t xn, uint32_t const *y, size_t yn) {
+    if (xn < yn) {
+        std::swap(x, y);
+        std::swap(xn, yn);
+    }
+    if (yn >= ROWS_THRESHOLD) {
+        std::shared_ptr<thread_pool> pool;
+        if (yn >= thread_pool::parallel_cutoff()) {
+            pool = thread_pool::instance();
+        }
+        std::vector<uint32_t> p(xn + yn);
+        limbs::mul(p.data(), x, xn, y, yn, pool.get());
+        add(p.data(), p.size());
+        return;
+    }
+    // position k takes the low half of x[k - j] * y[j] and the high half of x[k - j - 1] * y[j]
+    reserve(xn + yn, 2 * yn);
+    uint64_t *s = limbs.data();
+    for (size_t j = 0; j < yn; j++) {
+        uint64_t *row = s + j;
+        uint64_t m = y[j];
+        for (size_t i = 0; i < xn; i++) {
+            uint64_t p = x[i] * m;
+            row[i] += static_cast<uint32_t>(p);
+            row[i + 1] += p >> 32;
+        }
+    }
+}
+
+void big_integer_accumulator::sums::carry() {
+    uint64_t c = 0;
+    for (uint64_t &limb : limbs) {
+        // limb + c stays below 2^64: limb <= 2^64 - 2^32 after MAX_LOAD contributions and c < 2^32
+        uint64_t cur = limb + c;
+        limb = static_cast<uint32_t>(cur);
+        c = cur >> 32;
+    }
+    while (c != 0) {
+        limbs.push_back(static_cast<uint32_t>(c));
+        c >>= 32;
+    }
+    load = 1;
+}
+
+big_integer big_integer_accumulator::sums::value() const {
+    sums copy = *this;
+    copy.carry();
+    big_integer res;
+    res.val.resize(copy.limbs.size());
+    uint32_t *r = res.val.data();
+    for (size_t i = 0; i < copy.limbs.size(); i++) {
+        r[i] = static_cast<uint32_t>(copy.limbs[i]);
+    }
+    res.sign = 1;
+    res.shrink_to_fit();
+    return res;
+}
+
+big_integer_accumulator &big_integer_accumulator::operator+=(big_integer const &x) {
+    side(x.sign).add(x.data(), x.size());
+    return *this;
+}
+
+big_integer_accumulator &big_integer_accumulator::operator-=(big_integer const &x) {
+    side(-x.sign).add(x.data(), x.size());
+    return *this;
+}
+
+void big_integer_accumulator::addmul(big_integer const &x, big_integer const &y) {
+    side(x.sign * y.sign).add_product(x.data(), x.size(), y.data(), y.size());
+}
+
+void big_integer_accumulator::submul(big_integer const &x, big_integer const &y) {
+    side(-x.sign * y.sign).add_product(x.data(), x.size(), y.data(), y.size());
+}
+
+big_integer big_integer_accumulator::value() const {
+    return pos.value() - neg.value();
+}
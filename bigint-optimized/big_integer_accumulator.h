@@ -0,0 +1,54 @@
+#ifndef BIG_INTEGER_ACCUMULATOR_H
+#define BIG_INTEGER_ACCUMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+
+// Sum of many terms in carry-save form: every limb position keeps a 64-bit partial sum
+// of 32-bit contributions, positive and negative terms apart, and carries are propagated
+// only when the value is read or a partial sum could overflow. Products are added row by
+// row as the low and high halves of the limb products, so a dot product is one pass.
+struct big_integer_accumulator {
+    big_integer_accumulator();
+
+    big_integer_accumulator &operator+=(big_integer const &x);
+
+    big_integer_accumulator &operator-=(big_integer const &x);
+
+    // += x * y and -= x * y
+    void addmul(big_integer const &x, big_integer const &y);
+
+    void submul(big_integer const &x, big_integer const &y);
+
+    // the normalised sum
+    big_integer value() const;
+
+    void clear();
+
+private:
+    // partial sums of the terms of one sign
+    struct sums {
+        std::vector<uint64_t> limbs;
+        // contributions below 2^32 that any position may have taken since the last carry pass
+        uint64_t load = 0;
+
+        void reserve(size_t n, uint64_t contributions);
+
+        void add(uint32_t const *x, size_t n);
+
+        void add_product(uint32_t const *x, size_t xn, uint32_t const *y, size_t yn);
+
+        // every partial sum below 2^32 again
+        void carry();
+
+        big_integer value() const;
+    };
+
+    sums &side(int sign);
+
+    sums pos, neg;
+};
+
+#endif //BIG_INTEGER_ACCUMULATOR_H
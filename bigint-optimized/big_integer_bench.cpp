@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "big_integer.h"
+#include "big_integer_gmp.h"
+#include "big_integer_math.h"
+#include "montgomery_context.h"
+#include "thread_pool.h"
+
+namespace {
+
+struct options {
+    size_t max_limbs = 1000000;
+    double budget_ms = 2000;
+    double min_time_ms = 50;
+    double max_ratio = 0;
+    std::string ops;
+    std::vector<size_t> threads;
+};
+
+typedef std::chrono::steady_clock bench_clock;
+
+double elapsed_ns(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+}
+
+// builds the same value for both implementations out of 16-bit halves of random limbs
+template<typename T>
+T random_number(size_t limbs, std::mt19937 &rng) {
+    if (limbs == 1) {
+        uint32_t limb = rng() | 1;
+        T res(static_cast<int>(limb >> 16));
+        res <<= 16;
+        res += T(static_cast<int>(limb & 0xffff));
+        return res;
+    }
+    size_t low = limbs / 2;
+    T res = random_number<T>(limbs - low, rng);
+    res <<= static_cast<int>(32 * low);
+    res += random_number<T>(low, rng);
+    return res;
+}
+
+template<typename T>
+struct operands {
+    T a, b, half, modulus;
+    std::string str;
+    int shift;
+};
+
+template<typename T>
+operands<T> make_operands(size_t limbs, uint32_t seed) {
+    std::mt19937 rng(seed);
+    operands<T> res;
+    res.a = random_number<T>(limbs, rng);
+    res.b = random_number<T>(limbs, rng);
+    res.half = random_number<T>(limbs > 1 ? limbs / 2 : 1, rng);
+    res.modulus = random_number<T>(limbs, rng);
+    res.shift = static_cast<int>(16 * limbs + 5);
+    return res;
+}
+
+size_t const MULMOD_CHAIN = 16;
+
+// a run of products by the same odd modulus the way a modular exponentiation does
+// them, paying for the setup once per run like mpz_powm
+big_integer mulmod_chain(operands<big_integer> const &x) {
+    montgomery_context ctx(x.modulus);
+    montgomery_context::scratch scratch;
+    big_integer acc = ctx.to_montgomery(x.a);
+    big_integer b = ctx.to_montgomery(x.b);
+    for (size_t i = 0; i < MULMOD_CHAIN; i++) {
+        ctx.mul(acc, acc, b, scratch);
+    }
+    return ctx.from_montgomery(acc);
+}
+
+big_integer_gmp mulmod_chain(operands<big_integer_gmp> const &x) {
+    big_integer_gmp acc = x.a % x.modulus;
+    big_integer_gmp b = x.b % x.modulus;
+    for (size_t i = 0; i < MULMOD_CHAIN; i++) {
+        acc = acc * b % x.modulus;
+    }
+    return acc;
+}
+
+template<typename T>
+std::function<void()> make_op(std::string const &name, operands<T> &x, T &out) {
+    if (name == "add") return [&x, &out] { out = x.a + x.b; };
+    if (name == "sub") return [&x, &out] { out = x.a - x.b; };
+    if (name == "mul") return [&x, &out] { out = x.a * x.b; };
+    if (name == "div") return [&x, &out] { out = x.a / x.half; };
+    if (name == "mod") return [&x, &out] { out = x.a % x.half; };
+    if (name == "shl") return [&x, &out] { out = x.a << x.shift; };
+    if (name == "shr") return [&x, &out] { out = x.a >> x.shift; };
+    if (name == "and") return [&x, &out] { out = x.a & x.b; };
+    if (name == "or") return [&x, &out] { out = x.a | x.b; };
+    if (name == "xor") return [&x, &out] { out = x.a ^ x.b; };
+    if (name == "mulmod") return [&x, &out] { out = mulmod_chain(x); };
+    if (name == "to_string") return [&x, &out] { x.str = to_string(x.a); };
+    if (name == "parse") return [&x, &out] { out = T(x.str); };
+    return std::function<void()>();
+}
+
+// runs f until min_time_ms has passed, returns ns per call
+double run(std::function<void()> const &f, double min_time_ms, double &first_ns) {
+    auto start = bench_clock::now();
+    f();
+    first_ns = elapsed_ns(start);
+    double total = first_ns;
+    size_t iterations = 1;
+    while (total < min_time_ms * 1e6) {
+        auto batch_start = bench_clock::now();
+        f();
+        total += elapsed_ns(batch_start);
+        iterations++;
+    }
+    return total / static_cast<double>(iterations);
+}
+
+struct series {
+    bool exhausted = false;
+    size_t last_limbs = 0;
+    double last_first_ns = 0;
+
+    // quadratic extrapolation of the previous single call, the slowest tier we have
+    bool fits(size_t limbs, double budget_ms) const {
+        if (exhausted) {
+            return false;
+        }
+        if (last_limbs == 0) {
+            return true;
+        }
+        double ratio = static_cast<double>(limbs) / static_cast<double>(last_limbs);
+        return last_first_ns * ratio * ratio <= budget_ms * 1e6;
+    }
+
+    void record(size_t limbs, double first_ns, double budget_ms) {
+        last_limbs = limbs;
+        last_first_ns = first_ns;
+        exhausted = first_ns > budget_ms * 1e6;
+    }
+};
+
+bool parse_options(int argc, char **argv, options &opts) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        char const *value = argv[++i];
+        if (arg == "--max-limbs") {
+            opts.max_limbs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--budget-ms") {
+            opts.budget_ms = std::strtod(value, nullptr);
+        } else if (arg == "--min-time-ms") {
+            opts.min_time_ms = std::strtod(value, nullptr);
+        } else if (arg == "--max-ratio") {
+            opts.max_ratio = std::strtod(value, nullptr);
+        } else if (arg == "--ops") {
+            opts.ops = std::string(",") + value + ",";
+        } else if (arg == "--threads") {
+            std::string list = value;
+            for (size_t pos = 0; pos < list.size();) {
+                size_t comma = std::min(list.find(',', pos), list.size());
+                opts.threads.push_back(std::strtoull(list.substr(pos, comma - pos).c_str(), nullptr, 10));
+                pos = comma + 1;
+            }
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// speedup of a product of two limbs-sized numbers over the first thread count
+void scaling(size_t limbs, std::vector<size_t> const &threads, double min_time_ms) {
+    operands<big_integer> x = make_operands<big_integer>(limbs, 42);
+    big_integer out, reference;
+    double base_ns = 0, first_ns;
+    for (size_t i = 0; i < threads.size(); i++) {
+        thread_pool::set_threads(threads[i]);
+        double ns = run(make_op("mul", x, out), min_time_ms, first_ns);
+        if (i == 0) {
+            base_ns = ns;
+            reference = out;
+        }
+        std::printf("%-10s %10zu %10zu %18.0f %10.2f %s\n", "mul", limbs, threads[i], ns, base_ns / ns,
+                    out == reference ? "" : "  MISMATCH");
+        std::fflush(stdout);
+    }
+    thread_pool::set_threads(1);
+}
+
+// full-size exponents at the usual key sizes, by an odd and by an even modulus
+void modular_exponentiation(double min_time_ms) {
+    std::printf("\n%-10s %10s %10s %18s %18s %10s\n", "op", "bits", "modulus", "big_integer ns/op", "gmp ns/op",
+                "ratio");
+    for (size_t bits : {1024, 2048, 4096}) {
+        for (int parity = 1; parity >= 0; parity--) {
+            operands<big_integer> x = make_operands<big_integer>(bits / 32, 42);
+            operands<big_integer_gmp> y = make_operands<big_integer_gmp>(bits / 32, 42);
+            x.modulus -= 1 - parity;
+            y.modulus -= 1 - parity;
+            big_integer out;
+            big_integer_gmp gmp_out;
+            double first_ns;
+            double mine_ns = run([&] { out = pow_mod(x.a, x.b, x.modulus); }, min_time_ms, first_ns);
+            double gmp_ns = run([&] { gmp_out = pow_mod(y.a, y.b, y.modulus); }, min_time_ms, first_ns);
+            std::printf("%-10s %10zu %10s %18.0f %18.0f %10.2f%s\n", "pow_mod", bits, parity ? "odd" : "even",
+                        mine_ns, gmp_ns, mine_ns / gmp_ns, to_string(out) == to_string(gmp_out) ? "" : "  MISMATCH");
+            std::fflush(stdout);
+        }
+    }
+}
+
+void usage(char const *name) {
+    std::fprintf(stderr,
+                 "usage: %s [--max-limbs N] [--budget-ms T] [--min-time-ms T] [--max-ratio R] [--ops add,mul,...]\n"
+                 "          [--threads 1,2,4,...]\n"
+                 "  --max-limbs    largest operand size in 32-bit limbs (default 1000000)\n"
+                 "  --budget-ms    skip sizes whose single call is expected to exceed T ms (default 2000)\n"
+                 "  --min-time-ms  time spent on each measurement (default 50)\n"
+                 "  --max-ratio    exit with status 1 if big_integer is more than R times slower than gmp\n"
+                 "  --ops          comma separated subset of operations, mulmod is a run of 16 modular products,\n"
+                 "                 pow_mod runs at 1024, 2048 and 4096 bits\n"
+                 "  --threads      also time multiplication with each of these thread counts, e.g. 1,2,4,8,16,32\n",
+                 name);
+}
+}
+
+int main(int argc, char **argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<std::string> const names = {"add", "sub", "mul", "div", "mod", "shl", "shr",
+                                            "and", "or", "xor", "mulmod", "to_string", "parse"};
+    std::vector<series> mine(names.size()), gmp(names.size());
+    bool failed = false;
+
+    bool any_selected = opts.ops.empty();
+    for (std::string const &name : names) {
+        any_selected = any_selected || opts.ops.find("," + name + ",") != std::string::npos;
+    }
+
+    if (any_selected) {
+        std::printf("%-10s %10s %18s %18s %10s\n", "op", "limbs", "big_integer ns/op", "gmp ns/op", "ratio");
+    }
+    for (size_t limbs = 1; any_selected && limbs <= opts.max_limbs; limbs *= 10) {
+        operands<big_integer> x = make_operands<big_integer>(limbs, 42);
+        operands<big_integer_gmp> y = make_operands<big_integer_gmp>(limbs, 42);
+        x.str = y.str = to_string(y.a);
+        big_integer out;
+        big_integer_gmp gmp_out;
+
+        for (size_t i = 0; i < names.size(); i++) {
+            if (!opts.ops.empty() && opts.ops.find("," + names[i] + ",") == std::string::npos) {
+                continue;
+            }
+            double mine_ns = -1, gmp_ns = -1, first_ns;
+            if (mine[i].fits(limbs, opts.budget_ms)) {
+                mine_ns = run(make_op(names[i], x, out), opts.min_time_ms, first_ns);
+                mine[i].record(limbs, first_ns, opts.budget_ms);
+            }
+            if (gmp[i].fits(limbs, opts.budget_ms)) {
+                gmp_ns = run(make_op(names[i], y, gmp_out), opts.min_time_ms, first_ns);
+                gmp[i].record(limbs, first_ns, opts.budget_ms);
+            }
+            x.str = y.str;
+
+            std::printf("%-10s %10zu", names[i].c_str(), limbs);
+            if (mine_ns < 0) {
+                std::printf(" %18s", "skipped");
+            } else {
+                std::printf(" %18.0f", mine_ns);
+            }
+            if (gmp_ns < 0) {
+                std::printf(" %18s", "skipped");
+            } else {
+                std::printf(" %18.0f", gmp_ns);
+            }
+            if (mine_ns >= 0 && gmp_ns > 0) {
+                double ratio = mine_ns / gmp_ns;
+                bool bad = opts.max_ratio > 0 && ratio > opts.max_ratio;
+                failed = failed || bad;
+                std::printf(" %10.2f%s\n", ratio, bad ? "  FAIL" : "");
+            } else {
+                std::printf(" %10s\n", "-");
+            }
+            std::fflush(stdout);
+        }
+    }
+
+    if (opts.ops.empty() || opts.ops.find(",pow_mod,") != std::string::npos) {
+        modular_exponentiation(opts.min_time_ms);
+    }
+
+    if (!opts.threads.empty()) {
+        std::printf("\n%-10s %10s %10s %18s %10s\n", "op", "limbs", "threads", "ns/op", "speedup");
+        for (size_t limbs = 10000; limbs <= opts.max_limbs; limbs *= 10) {
+            scaling(limbs, opts.threads, opts.min_time_ms);
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+#include "big_integer_bytes.h"
+#include "limb_ops.h"
+#include <stdexcept>
+
+namespace {
+    // the shifts compile to single (byte swapping) stores and loads
+    void store_le(uint8_t *p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v);
+        p[1] = static_cast<uint8_t>(v >> 8);
+        p[2] = static_cast<uint8_t>(v >> 16);
+        p[3] = static_cast<uint8_t>(v >> 24);
+    }
+
+    void store_be(uint8_t *p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v >> 24);
+        p[1] = static_cast<uint8_t>(v >> 16);
+        p[2] = static_cast<uint8_t>(v >> 8);
+        p[3] = static_cast<uint8_t>(v);
+    }
+
+    uint32_t load_le(uint8_t const *p) {
+        return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+    }
+
+    uint32_t load_be(uint8_t const *p) {
+        return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]);
+    }
+
+    bool is_power_of_two(big_integer_view x) {
+        uint32_t const *a = x.data();
+        size_t n = x.size();
+        for (size_t i = 0; i + 1 < n; i++) {
+            if (a[i] != 0) {
+                return false;
+            }
+        }
+        return (a[n - 1] & (a[n - 1] - 1)) == 0;
+    }
+}
+
+size_t byte_length(big_integer_view x, byte_format format) {
+    size_t bits = bit_length(x);
+    if (format == byte_format::magnitude) {
+        return (bits + 7) / 8;
+    }
+    // -2^(8k-1) still fits k bytes
+    if (x.sign() < 0 && is_power_of_two(x)) {
+        bits--;
+    }
+    return bits / 8 + 1;
+}
+
+void to_bytes(big_integer_view x, uint8_t *out, byte_order order, byte_format format) {
+    size_t len = byte_length(x, format);
+    uint32_t const *a = x.data();
+    size_t n = x.size();
+    // a negative two's complement is ~|x| + 1, and all ones past the limbs of |x|
+    bool complement = format == byte_format::twos_complement && x.sign() < 0;
+    uint32_t mask = complement ? ~uint32_t(0) : 0;
+    uint64_t carry = complement ? 1 : 0;
+    size_t full = len / 4;
+    bool little = order == byte_order::little_endian;
+    for (size_t i = 0; i <= full; i++) {
+        uint32_t limb = i < n ? a[i] : 0;
+        uint64_t cur = uint64_t(limb ^ mask) + carry;
+        carry = cur >> 32;
+        uint32_t v = static_cast<uint32_t>(cur);
+        if (i < full) {
+            if (little) {
+                store_le(out + 4 * i, v);
+            } else {
+                store_be(out + len - 4 * (i + 1), v);
+            }
+            continue;
+        }
+        for (size_t j = 0; j < len % 4; j++) {
+            uint8_t byte = static_cast<uint8_t>(v >> (8 * j));
+            if (little) {
+                out[4 * i + j] = byte;
+            } else {
+                out[len - 1 - 4 * i - j] = byte;
+            }
+        }
+    }
+}
+
+std::vector<uint8_t> to_bytes(big_integer_view x, byte_order order, byte_format format) {
+    std::vector<uint8_t> out(byte_length(x, format));
+    to_bytes(x, out.data(), order, format);
+    return out;
+}
+
+big_integer from_bytes(uint8_t const *data, size_t n, byte_order order, byte_format format) {
+    big_integer res;
+    if (n == 0) {
+        return res;
+    }
+    bool little = order == byte_order::little_endian;
+    bool negative = format == byte_format::twos_complement && (data[little ? n - 1 : 0] & 0x80) != 0;
+    size_t full = n / 4;
+    res.val.resize(full + (n % 4 != 0));
+    uint32_t *r = res.val.data();
+    for (size_t i = 0; i < full; i++) {
+        r[i] = little ? load_le(data + 4 * i) : load_be(data + n - 4 * (i + 1));
+    }
+    if (n % 4 != 0) {
+        // the partial top limb is sign extended
+        uint32_t top = negative ? ~uint32_t(0) : 0;
+        for (size_t j = 0; j < n % 4; j++) {
+            uint32_t byte = little ? data[4 * full + j] : data[n - 1 - 4 * full - j];
+            top = (top & ~(uint32_t(0xff) << (8 * j))) | byte << (8 * j);
+        }
+        r[full] = top;
+    }
+    if (negative) {
+        size_t rn = res.size();
+        for (size_t i = 0; i < rn; i++) {
+            r[i] = ~r[i];
+        }
+        limbs::add_1(r, r, rn, 1);
+        res.sign = -1;
+    }
+    res.shrink_to_fit();
+    return res;
+}
+
+void serialize(big_integer_view x, std::vector<uint8_t> &out) {
+    size_t len = byte_length(x, byte_format::magnitude);
+    uint64_t header = uint64_t(len) << 1 | (x.sign() < 0);
+    while (header >= 0x80) {
+        out.push_back(static_cast<uint8_t>(header | 0x80));
+        header >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(header));
+    size_t pos = out.size();
+    out.resize(pos + len);
+    to_bytes(x, out.data() + pos, byte_order::little_endian, byte_format::magnitude);
+}
+
+big_integer deserialize(uint8_t const *&first, uint8_t const *last) {
+    uint8_t const *p = first;
+    uint64_t header = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        if (p == last || shift > 63) {
+            throw std::invalid_argument("deserialize: malformed length");
+        }
+        header |= uint64_t(*p & 0x7f) << shift;
+        if ((*p++ & 0x80) == 0) {
+            break;
+        }
+    }
+    uint64_t len = header >> 1;
+    if (len > static_cast<uint64_t>(last - p)) {
+        throw std::invalid_argument("deserialize: truncated value");
+    }
+    big_integer res = from_bytes(p, static_cast<size_t>(len));
+    if ((header & 1) != 0) {
+        res = -res;
+    }
+    first = p + len;
+    return res;
+}
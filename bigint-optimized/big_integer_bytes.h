@@ -0,0 +1,42 @@
+#ifndef BIG_INTEGER_BYTES_H
+#define BIG_INTEGER_BYTES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+#include "big_integer_view.h"
+
+enum class byte_order {
+    little_endian,
+    big_endian
+};
+
+// magnitude drops the sign like mpz_export, twos_complement keeps it in the top bit
+enum class byte_format {
+    magnitude,
+    twos_complement
+};
+
+// bytes written by to_bytes: the magnitude, 0 for zero, or the shortest two's complement
+size_t byte_length(big_integer_view x, byte_format format);
+
+// writes byte_length(x, format) bytes to out, a limb at a time
+void to_bytes(big_integer_view x, uint8_t *out, byte_order order, byte_format format);
+
+std::vector<uint8_t> to_bytes(big_integer_view x, byte_order order = byte_order::little_endian,
+                              byte_format format = byte_format::magnitude);
+
+// any length, a two's complement value is negative when the top bit of its last byte in order is set
+big_integer from_bytes(uint8_t const *data, size_t n, byte_order order = byte_order::little_endian,
+                       byte_format format = byte_format::magnitude);
+
+// appends x as a LEB128 varint of (magnitude bytes << 1 | negative) followed by the
+// magnitude little-endian; zero is the single byte 0
+void serialize(big_integer_view x, std::vector<uint8_t> &out);
+
+// reads a value written by serialize from [first, last) and moves first past it.
+// Throws std::invalid_argument for truncated or malformed input.
+big_integer deserialize(uint8_t const *&first, uint8_t const *last);
+
+#endif //BIG_INTEGER_BYTES_H
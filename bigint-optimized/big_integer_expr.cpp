@@ -0,0 +1,106 @@
+#include "big_integer_expr.h"
+#include "limb_ops.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    void mul_limbs(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn) {
+        std::shared_ptr<thread_pool> pool;
+        if (std::min(an, bn) >= thread_pool::parallel_cutoff()) {
+            pool = thread_pool::instance();
+        }
+        if (a == b && an == bn) {
+            limbs::sqr(r, a, an, pool.get());
+        } else if (an >= bn) {
+            limbs::mul(r, a, an, b, bn, pool.get());
+        } else {
+            limbs::mul(r, b, bn, a, an, pool.get());
+        }
+    }
+}
+
+void big_integer_eval::mul(big_integer &dst, big_integer const &a, big_integer const &b) {
+    if (&dst == &a || &dst == &b) {
+        big_integer tmp;
+        mul(tmp, a, b);
+        dst.swap(tmp);
+        return;
+    }
+    size_t an = a.size(), bn = b.size();
+    dst.val.resize(an + bn);
+    mul_limbs(dst.val.data(), a.data(), an, b.data(), bn);
+    dst.sign = a.sign * b.sign;
+    dst.shrink_to_fit();
+    if (dst.size() == 1 && dst.val[0] == 0) {
+        dst.sign = 1;
+    }
+}
+
+void big_integer_eval::add(big_integer &dst, big_integer const &x, int s) {
+    // a copy shares the limbs, writing to dst then leaves them alone
+    big_integer keep = x;
+    add_limbs(dst, keep.data(), keep.size(), keep.sign * s);
+}
+
+void big_integer_eval::add_mul(big_integer &dst, big_integer const &a, big_integer const &b, int s) {
+    if (s > 0) {
+        addmul(dst, a, b);
+    } else {
+        submul(dst, a, b);
+    }
+}
+
+void big_integer_eval::mod(big_integer &dst, big_integer const &m) {
+    if (m == 0) {
+        throw std::runtime_error("found divide by zero");
+    }
+    size_t dn = dst.size(), mn = m.size();
+    if (dn < mn) {
+        return;
+    }
+    // only the quotient needs memory of its own, dst is unshared before it is written
+    std::vector<uint32_t> q(dn - mn + 1);
+    uint32_t *d = dst.val.data();
+    limbs::divrem(q.data(), d, d, dn, m.data(), mn);
+    dst.val.resize(mn);
+    dst.shrink_to_fit();
+    if (dst.size() == 1 && dst.val[0] == 0) {
+        dst.sign = 1;
+    }
+}
+
+void big_integer_eval::negate(big_integer &dst) {
+    if (dst.size() != 1 || dst.val[0] != 0) {
+        dst.sign = -dst.sign;
+    }
+}
+
+void big_integer_eval::add_limbs(big_integer &dst, uint32_t const *x, size_t xn, int xs) {
+    size_t dn = dst.size();
+    if (dst.sign == xs || (dn == 1 && dst.val[0] == 0)) {
+        if (dn == 1 && dst.val[0] == 0) {
+            dst.sign = xs;
+        }
+        size_t n = std::max(dn, xn);
+        dst.val.resize(n + 1);
+        uint32_t *d = dst.val.data();
+        d[n] = dn >= xn ? limbs::add(d, d, dn, x, xn) : limbs::add(d, x, xn, d, dn);
+    } else {
+        int c = dn != xn ? (dn < xn ? -1 : 1) : limbs::cmp(dst.data(), x, dn);
+        if (c >= 0) {
+            uint32_t *d = dst.val.data();
+            limbs::sub(d, d, dn, x, xn);
+        } else {
+            dst.val.resize(xn);
+            uint32_t *d = dst.val.data();
+            limbs::sub(d, x, xn, d, dn);
+            dst.sign = xs;
+        }
+    }
+    dst.shrink_to_fit();
+    if (dst.size() == 1 && dst.val[0] == 0) {
+        dst.sign = 1;
+    }
+}
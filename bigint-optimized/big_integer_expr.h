@@ -0,0 +1,287 @@
+#ifndef BIG_INTEGER_EXPR_H
+#define BIG_INTEGER_EXPR_H
+
+#include "big_integer.h"
+
+// Expression templates over big_integer in the spirit of gmpxx. lazy(a) starts a tree,
+// so that r = lazy(a) * b + c * d - e is evaluated once, on assignment, straight into r:
+// a sum whose operand is a plain value is computed in place, a scratch value is taken
+// only where both operands are compound. a * b + c, c + a * b and their differences go
+// through an in place product-add, and (a * b) % m reduces the product where it lies.
+// The tree holds references to its leaves, so it has to be evaluated within the statement
+// that builds it; when the destination is one of the leaves a temporary is used.
+
+// in place primitives the evaluation is made of
+struct big_integer_eval {
+    // dst = a * b, reusing the limbs of dst
+    static void mul(big_integer &dst, big_integer const &a, big_integer const &b);
+
+    // dst += s * x for s = 1 or -1, in place
+    static void add(big_integer &dst, big_integer const &x, int s);
+
+    // dst += s * a * b for s = 1 or -1
+    static void add_mul(big_integer &dst, big_integer const &a, big_integer const &b, int s);
+
+    // dst = dst % m with the sign of dst, the remainder overwrites the limbs of dst
+    static void mod(big_integer &dst, big_integer const &m);
+
+    static void negate(big_integer &dst);
+
+private:
+    static void add_limbs(big_integer &dst, uint32_t const *x, size_t xn, int xs);
+};
+
+template<typename E>
+struct big_integer_expr {
+    E const &self() const {
+        return static_cast<E const &>(*this);
+    }
+};
+
+struct big_integer_ref : big_integer_expr<big_integer_ref> {
+    explicit big_integer_ref(big_integer const &v) : v(v) {}
+
+    void eval(big_integer &dst) const {
+        dst = v;
+    }
+
+    bool refers(big_integer const *p) const {
+        return &v == p;
+    }
+
+    big_integer const &v;
+};
+
+struct big_integer_add {};
+struct big_integer_sub {};
+struct big_integer_mul {};
+struct big_integer_div {};
+struct big_integer_mod {};
+
+template<typename Op, typename L, typename R>
+struct big_integer_binary : big_integer_expr<big_integer_binary<Op, L, R>> {
+    big_integer_binary(L const &l, R const &r) : l(l), r(r) {}
+
+    void eval(big_integer &dst) const;
+
+    bool refers(big_integer const *p) const {
+        return l.refers(p) || r.refers(p);
+    }
+
+    L l;
+    R r;
+};
+
+template<typename E>
+struct big_integer_neg : big_integer_expr<big_integer_neg<E>> {
+    explicit big_integer_neg(E const &e) : e(e) {}
+
+    void eval(big_integer &dst) const {
+        e.eval(dst);
+        big_integer_eval::negate(dst);
+    }
+
+    bool refers(big_integer const *p) const {
+        return e.refers(p);
+    }
+
+    E e;
+};
+
+inline big_integer_ref lazy(big_integer const &a) {
+    return big_integer_ref(a);
+}
+
+namespace big_integer_detail {
+    template<typename A, typename B>
+    using product = big_integer_binary<big_integer_mul, A, B>;
+
+    // the value of a leaf, anything else evaluated into scratch
+    inline big_integer const &operand(big_integer_ref const &e, big_integer &) {
+        return e.v;
+    }
+
+    template<typename E>
+    big_integer const &operand(E const &e, big_integer &scratch) {
+        e.eval(scratch);
+        return scratch;
+    }
+
+    // dst = l + s * r, dst not referred to by l or r
+    template<typename L, typename R>
+    void eval_sum(L const &l, R const &r, int s, big_integer &dst) {
+        l.eval(dst);
+        big_integer scratch;
+        big_integer_eval::add(dst, operand(r, scratch), s);
+    }
+
+    template<typename R>
+    void eval_sum(big_integer_ref const &l, R const &r, int s, big_integer &dst) {
+        r.eval(dst);
+        if (s < 0) {
+            big_integer_eval::negate(dst);
+        }
+        big_integer_eval::add(dst, l.v, 1);
+    }
+
+    inline void eval_sum(big_integer_ref const &l, big_integer_ref const &r, int s, big_integer &dst) {
+        dst = l.v;
+        big_integer_eval::add(dst, r.v, s);
+    }
+
+    template<typename L, typename A, typename B>
+    void eval_sum(L const &l, product<A, B> const &r, int s, big_integer &dst) {
+        l.eval(dst);
+        big_integer sa, sb;
+        big_integer_eval::add_mul(dst, operand(r.l, sa), operand(r.r, sb), s);
+    }
+
+    template<typename A, typename B, typename R>
+    void eval_sum(product<A, B> const &l, R const &r, int s, big_integer &dst) {
+        r.eval(dst);
+        if (s < 0) {
+            big_integer_eval::negate(dst);
+        }
+        big_integer sa, sb;
+        big_integer_eval::add_mul(dst, operand(l.l, sa), operand(l.r, sb), 1);
+    }
+
+    template<typename A, typename B>
+    void eval_sum(big_integer_ref const &l, product<A, B> const &r, int s, big_integer &dst) {
+        dst = l.v;
+        big_integer sa, sb;
+        big_integer_eval::add_mul(dst, operand(r.l, sa), operand(r.r, sb), s);
+    }
+
+    template<typename A, typename B>
+    void eval_sum(product<A, B> const &l, big_integer_ref const &r, int s, big_integer &dst) {
+        dst = r.v;
+        if (s < 0) {
+            big_integer_eval::negate(dst);
+        }
+        big_integer sa, sb;
+        big_integer_eval::add_mul(dst, operand(l.l, sa), operand(l.r, sb), 1);
+    }
+
+    template<typename A, typename B, typename C, typename D>
+    void eval_sum(product<A, B> const &l, product<C, D> const &r, int s, big_integer &dst) {
+        big_integer sa, sb;
+        big_integer_eval::mul(dst, operand(l.l, sa), operand(l.r, sb));
+        big_integer_eval::add_mul(dst, operand(r.l, sa), operand(r.r, sb), s);
+    }
+
+    // dst += s * e, dst not referred to by e
+    template<typename E>
+    void accumulate(big_integer &dst, E const &e, int s) {
+        big_integer scratch;
+        big_integer_eval::add(dst, operand(e, scratch), s);
+    }
+
+    template<typename A, typename B>
+    void accumulate(big_integer &dst, product<A, B> const &e, int s) {
+        big_integer sa, sb;
+        big_integer_eval::add_mul(dst, operand(e.l, sa), operand(e.r, sb), s);
+    }
+
+    template<typename L, typename R>
+    void eval(big_integer_add, L const &l, R const &r, big_integer &dst) {
+        eval_sum(l, r, 1, dst);
+    }
+
+    template<typename L, typename R>
+    void eval(big_integer_sub, L const &l, R const &r, big_integer &dst) {
+        eval_sum(l, r, -1, dst);
+    }
+
+    template<typename L, typename R>
+    void eval(big_integer_mul, L const &l, R const &r, big_integer &dst) {
+        big_integer sl, sr;
+        big_integer_eval::mul(dst, operand(l, sl), operand(r, sr));
+    }
+
+    template<typename L, typename R>
+    void eval(big_integer_div, L const &l, R const &r, big_integer &dst) {
+        l.eval(dst);
+        big_integer scratch;
+        dst /= operand(r, scratch);
+    }
+
+    // a product on the left lands in dst and is reduced there
+    template<typename L, typename R>
+    void eval(big_integer_mod, L const &l, R const &r, big_integer &dst) {
+        l.eval(dst);
+        big_integer scratch;
+        big_integer_eval::mod(dst, operand(r, scratch));
+    }
+}
+
+template<typename Op, typename L, typename R>
+void big_integer_binary<Op, L, R>::eval(big_integer &dst) const {
+    big_integer_detail::eval(Op(), l, r, dst);
+}
+
+template<typename E>
+big_integer::big_integer(big_integer_expr<E> const &e) : big_integer() {
+    e.self().eval(*this);
+}
+
+template<typename E>
+big_integer &big_integer::operator=(big_integer_expr<E> const &e) {
+    if (e.self().refers(this)) {
+        big_integer tmp(e);
+        swap(tmp);
+    } else {
+        e.self().eval(*this);
+    }
+    return *this;
+}
+
+template<typename E>
+big_integer &big_integer::operator+=(big_integer_expr<E> const &e) {
+    if (e.self().refers(this)) {
+        return *this += big_integer(e);
+    }
+    big_integer_detail::accumulate(*this, e.self(), 1);
+    return *this;
+}
+
+template<typename E>
+big_integer &big_integer::operator-=(big_integer_expr<E> const &e) {
+    if (e.self().refers(this)) {
+        return *this -= big_integer(e);
+    }
+    big_integer_detail::accumulate(*this, e.self(), -1);
+    return *this;
+}
+
+#define BIG_INTEGER_EXPR_OPERATOR(op, tag)                                                  \
+    template<typename L, typename R>                                                        \
+    big_integer_binary<tag, L, R> operator op(big_integer_expr<L> const &l,                 \
+                                              big_integer_expr<R> const &r) {               \
+        return big_integer_binary<tag, L, R>(l.self(), r.self());                           \
+    }                                                                                       \
+    template<typename L>                                                                    \
+    big_integer_binary<tag, L, big_integer_ref> operator op(big_integer_expr<L> const &l,   \
+                                                            big_integer const &r) {         \
+        return big_integer_binary<tag, L, big_integer_ref>(l.self(), big_integer_ref(r));   \
+    }                                                                                       \
+    template<typename R>                                                                    \
+    big_integer_binary<tag, big_integer_ref, R> operator op(big_integer const &l,           \
+                                                            big_integer_expr<R> const &r) { \
+        return big_integer_binary<tag, big_integer_ref, R>(big_integer_ref(l), r.self());   \
+    }
+
+BIG_INTEGER_EXPR_OPERATOR(+, big_integer_add)
+BIG_INTEGER_EXPR_OPERATOR(-, big_integer_sub)
+BIG_INTEGER_EXPR_OPERATOR(*, big_integer_mul)
+BIG_INTEGER_EXPR_OPERATOR(/, big_integer_div)
+BIG_INTEGER_EXPR_OPERATOR(%, big_integer_mod)
+
+#undef BIG_INTEGER_EXPR_OPERATOR
+
+template<typename E>
+big_integer_neg<E> operator-(big_integer_expr<E> const &e) {
+    return big_integer_neg<E>(e.self());
+}
+
+#endif //BIG_INTEGER_EXPR_H
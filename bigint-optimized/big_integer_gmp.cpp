@@ -195,6 +195,16 @@ std::string to_string(big_integer_gmp const& a) {
   return res;
 }
 
+big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exp, big_integer_gmp const& mod) {
+  big_integer_gmp result;
+  mpz_powm(result.mpz, base.mpz, exp.mpz, mod.mpz);
+  return result;
+}
+
+bool is_probable_prime(big_integer_gmp const& a) {
+  return mpz_probab_prime_p(a.mpz, 25) != 0;
+}
+
 std::ostream& operator<<(std::ostream& s, big_integer_gmp const& a) {
   return s << to_string(a);
 }
\ No newline at end of file
@@ -60,6 +60,11 @@ struct big_integer_gmp {
 
   friend std::string to_string(big_integer_gmp const& a);
 
+  friend big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exp,
+                                 big_integer_gmp const& mod);
+
+  friend bool is_probable_prime(big_integer_gmp const& a);
+
  private:
   mpz_t mpz;
 };
@@ -85,6 +90,7 @@ bool operator<=(big_integer_gmp const& a, big_integer_gmp const& b);
 bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b);
 
 std::string to_string(big_integer_gmp const& a);
+big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exp, big_integer_gmp const& mod);
 std::ostream& operator<<(std::ostream& s, big_integer_gmp const& a);
 
 #endif // BIG_INTEGER_GMP_H
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef BIG_INTEGER_IMPL_H
+#define BIG_INTEGER_IMPL_H
+
+#include <cstddef>
+#include "big_integer.h"
+#include "big_integer_view.h"
+
+// Decimal conversion shared by big_integer.cpp and big_integer_radix.cpp; not part of
+// the public interface.
+
+// len > 0 decimal digits, the halves of long strings are read side by side on the pool
+big_integer parse_decimal(char const *str, size_t len);
+
+// the decimal digits of |a| != 0 into [first, last), returns their end or nullptr when they do not fit
+char *write_decimal_chars(big_integer_view a, char *first, char *last);
+
+#endif //BIG_INTEGER_IMPL_H
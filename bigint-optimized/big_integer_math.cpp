@@ -0,0 +1,1270 @@
+#include "big_integer_math.h"
+#include "barrett_context.h"
+#include "big_integer_accumulator.h"
+#include "big_integer_view.h"
+#include "limb_ops.h"
+#include "montgomery_context.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// operands below this many limbs are reduced by Lehmer steps only
+static const size_t HGCD_THRESHOLD = 160;
+
+namespace {
+    struct montgomery_ring {
+        explicit montgomery_ring(big_integer const &mod) : ctx(mod) {}
+
+        big_integer one() const {
+            return ctx.one();
+        }
+
+        big_integer to_ring(big_integer const &a) const {
+            return ctx.to_montgomery(a);
+        }
+
+        big_integer from_ring(big_integer const &a) const {
+            return ctx.from_montgomery(a);
+        }
+
+        void mul(big_integer &r, big_integer const &a, big_integer const &b) {
+            ctx.mul(r, a, b, scratch);
+        }
+
+        void sqr(big_integer &r, big_integer const &a) {
+            ctx.sqr(r, a, scratch);
+        }
+
+        montgomery_context ctx;
+        montgomery_context::scratch scratch;
+    };
+
+    struct barrett_ring {
+        explicit barrett_ring(big_integer const &mod) : ctx(mod) {}
+
+        big_integer one() const {
+            return 1;
+        }
+
+        big_integer to_ring(big_integer const &a) const {
+            return ctx.reduce(a);
+        }
+
+        big_integer from_ring(big_integer const &a) const {
+            return a;
+        }
+
+        void mul(big_integer &r, big_integer const &a, big_integer const &b) {
+            r = ctx.reduce(a * b);
+        }
+
+        void sqr(big_integer &r, big_integer const &a) {
+            r = ctx.reduce(a * a);
+        }
+
+        barrett_context ctx;
+    };
+
+    // window width that minimises squarings plus table products for this many exponent bits
+    size_t window_bits(size_t bits) {
+        size_t const limits[] = {7, 25, 81, 241, 673, 1793};
+        size_t w = 1;
+        while (w <= 6 && bits > limits[w - 1]) {
+            w++;
+        }
+        return w;
+    }
+
+    big_integer binary_pow(big_integer const &base, uint64_t exp) {
+        big_integer res = base;
+        for (int i = 62 - __builtin_clzll(exp); i >= 0; i--) {
+            res *= res;
+            if ((exp >> i) & 1) {
+                res *= base;
+            }
+        }
+        return res;
+    }
+
+    template<typename Ring>
+    big_integer sliding_window(Ring &ring, big_integer const &base, uint32_t const *exp, size_t bits) {
+        auto bit = [exp](size_t i) {
+            return (exp[i / 32] >> (i % 32)) & 1;
+        };
+        size_t w = window_bits(bits);
+
+        // odd powers base^1, base^3, ..., base^(2^w - 1)
+        std::vector<big_integer> table(size_t(1) << (w - 1));
+        table[0] = ring.to_ring(base);
+        big_integer square;
+        if (table.size() > 1) {
+            ring.sqr(square, table[0]);
+        }
+        for (size_t i = 1; i < table.size(); i++) {
+            ring.mul(table[i], table[i - 1], square);
+        }
+
+        big_integer acc = ring.one();
+        bool started = false;
+        size_t i = bits;
+        while (i != 0) {
+            if (!bit(i - 1)) {
+                if (started) {
+                    ring.sqr(acc, acc);
+                }
+                i--;
+                continue;
+            }
+            // the longest window of at most w bits ending in a one
+            size_t low = i > w ? i - w : 0;
+            while (!bit(low)) {
+                low++;
+            }
+            size_t value = 0;
+            for (size_t j = i; j != low; j--) {
+                value = value * 2 + bit(j - 1);
+                if (started) {
+                    ring.sqr(acc, acc);
+                }
+            }
+            if (started) {
+                ring.mul(acc, acc, table[value / 2]);
+            } else {
+                acc = table[value / 2];
+                started = true;
+            }
+            i = low;
+        }
+        return ring.from_ring(acc);
+    }
+}
+
+big_integer pow_mod(big_integer const &base, big_integer const &exp, big_integer const &mod) {
+    if (mod <= 0) {
+        throw std::invalid_argument("pow_mod: modulus must be positive");
+    }
+    if (exp < 0) {
+        throw std::invalid_argument("pow_mod: negative exponent");
+    }
+    if (mod == 1) {
+        return 0;
+    }
+    if (exp == 0) {
+        return 1;
+    }
+    uint32_t const *e = exp.data();
+    size_t bits = 32 * exp.size() - __builtin_clz(e[exp.size() - 1]);
+    if (mod.data()[0] & 1) {
+        montgomery_ring ring(mod);
+        return sliding_window(ring, base, e, bits);
+    }
+    barrett_ring ring(mod);
+    return sliding_window(ring, base, e, bits);
+}
+
+big_integer pow(big_integer const &base, uint64_t exp) {
+    if (exp == 0) {
+        return 1;
+    }
+    if (base == 0) {
+        return 0;
+    }
+    uint32_t const *b = base.data();
+    size_t zero_limbs = 0;
+    while (b[zero_limbs] == 0) {
+        zero_limbs++;
+    }
+    uint64_t zero_bits = 32 * zero_limbs + __builtin_ctz(b[zero_limbs]);
+    big_integer odd = base >= 0 ? base : -base;
+    odd >>= static_cast<int>(zero_bits);
+
+    big_integer res = 1;
+    if (odd.size() == 1 && odd.data()[0] != 1) {
+        uint32_t limb = odd.data()[0];
+        uint32_t limb_power = limb;
+        uint64_t per_limb = 1;
+        while (limb_power <= UINT32_MAX / limb) {
+            limb_power *= limb;
+            per_limb++;
+        }
+        uint32_t rest = 1;
+        for (uint64_t i = 0; i < exp % per_limb; i++) {
+            rest *= limb;
+        }
+        if (exp >= per_limb) {
+            res = binary_pow(big_integer(limb_power), exp / per_limb);
+        }
+        res *= big_integer(rest);
+    } else if (odd.size() > 1) {
+        res = binary_pow(odd, exp);
+    }
+    if (zero_bits != 0) {
+        if (zero_bits > static_cast<uint64_t>(INT_MAX) / exp) {
+            throw std::length_error("pow: result too large");
+        }
+        res <<= static_cast<int>(zero_bits * exp);
+    }
+    if (base < 0 && (exp & 1)) {
+        res = -res;
+    }
+    return res;
+}
+
+size_t bit_length(big_integer const &a) {
+    return bit_length(big_integer_view(a));
+}
+
+namespace {
+    // (x, y) -> (a * x + b * y, c * x + d * y) with determinant 1 or -1, so gcd(x, y) is kept
+    struct gcd_matrix {
+        big_integer a = 1, b = 0, c = 0, d = 1;
+
+        void apply(big_integer &x, big_integer &y) const {
+            big_integer nx = a * x + b * y;
+            y = c * x + d * y;
+            x = nx;
+        }
+
+        // this = step * this
+        void prepend(gcd_matrix const &step) {
+            step.apply(a, c);
+            step.apply(b, d);
+        }
+
+        void swap_rows() {
+            std::swap(a, c);
+            std::swap(b, d);
+        }
+    };
+
+    size_t limb_count(big_integer const &a) {
+        return std::max<size_t>(1, (bit_length(a) + 31) / 32);
+    }
+
+    uint64_t binary_gcd(uint64_t x, uint64_t y) {
+        if (x == 0 || y == 0) {
+            return x | y;
+        }
+        int shift = __builtin_ctzll(x | y);
+        x >>= __builtin_ctzll(x);
+        while (y != 0) {
+            y >>= __builtin_ctzll(y);
+            if (x > y) {
+                std::swap(x, y);
+            }
+            y -= x;
+        }
+        return x << shift;
+    }
+
+    big_integer from_uint64(uint64_t v) {
+        return (big_integer(static_cast<uint32_t>(v >> 32)) << 32) + big_integer(static_cast<uint32_t>(v));
+    }
+
+    // x, y = y, x mod y
+    gcd_matrix euclid_step(big_integer &x, big_integer &y) {
+        big_integer q, r;
+        divmod_abs(x, y, q, r);
+        x = y;
+        y = r;
+        gcd_matrix m;
+        m.a = 0;
+        m.b = 1;
+        m.c = 1;
+        m.d = -q;
+        return m;
+    }
+
+    // Knuth's algorithm L on the leading 64 bits: a quotient is taken only when both
+    // bounds of the true one agree, so the matrix is exact for x and y themselves.
+    // Cofactors stay within an int. Returns false when no quotient could be taken.
+    bool lehmer_matrix(big_integer const &x, big_integer const &y, gcd_matrix &m) {
+        size_t bits = bit_length(x);
+        size_t shift = bits > 64 ? bits - 64 : 0;
+        int128_t xh = bits_at(x, shift), yh = bits_at(y, shift);
+        int128_t a = 1, b = 0, c = 0, d = 1;
+        while (yh + c > 0 && yh + d > 0) {
+            int128_t q = (xh + a) / (yh + c);
+            if (q != (xh + b) / (yh + d)) {
+                break;
+            }
+            int128_t na = a - q * c, nb = b - q * d;
+            if (na > INT_MAX || na < -INT_MAX || nb > INT_MAX || nb < -INT_MAX) {
+                break;
+            }
+            a = c;
+            c = na;
+            b = d;
+            d = nb;
+            int128_t t = xh - q * yh;
+            xh = yh;
+            yh = t;
+        }
+        if (b == 0) {
+            return false;
+        }
+        m.a = static_cast<int>(a);
+        m.b = static_cast<int>(b);
+        m.c = static_cast<int>(c);
+        m.d = static_cast<int>(d);
+        return true;
+    }
+
+    gcd_matrix hgcd(big_integer x, big_integer y);
+
+    // One reduction of x >= y > 0, applied to both; the matrix is returned. A recursive
+    // call is allowed to bring y down to no fewer than limit limbs.
+    gcd_matrix gcd_step(big_integer &x, big_integer &y, size_t limit) {
+        if (limb_count(x) > limb_count(y) + 1 || limb_count(y) <= 2) {
+            return euclid_step(x, y);
+        }
+        size_t excess = limb_count(y) - limit;
+        if (limb_count(y) >= HGCD_THRESHOLD && excess >= HGCD_THRESHOLD / 4) {
+            // reducing the top 2e limbs to about half removes about e limbs of the full values;
+            // a wrong last quotient only shows up as a negative or not reduced result
+            size_t top = std::min(2 * excess, limb_count(x) / 2);
+            int shift = static_cast<int>(32 * (limb_count(x) - top));
+            big_integer xt = x >> shift, yt = y >> shift;
+            if (yt != 0) {
+                gcd_matrix m = hgcd(xt, yt);
+                big_integer nx = x, ny = y;
+                m.apply(nx, ny);
+                if (nx >= 0 && ny >= 0 && nx <= x && std::min(nx, ny) < y) {
+                    if (nx < ny) {
+                        std::swap(nx, ny);
+                        m.swap_rows();
+                    }
+                    x = nx;
+                    y = ny;
+                    return m;
+                }
+            }
+        }
+        gcd_matrix m;
+        if (!lehmer_matrix(x, y, m)) {
+            return euclid_step(x, y);
+        }
+        m.apply(x, y);
+        return m;
+    }
+
+    // reduces x >= y >= 0 until y has at most half the limbs of x plus one
+    gcd_matrix hgcd(big_integer x, big_integer y) {
+        size_t limit = limb_count(x) / 2 + 1;
+        gcd_matrix m;
+        while (y != 0 && limb_count(y) > limit) {
+            m.prepend(gcd_step(x, y, limit));
+        }
+        return m;
+    }
+
+    // runs the reduction to the end, following the coefficient of the first operand if asked
+    big_integer gcd_impl(big_integer x, big_integer y, big_integer *coefficient) {
+        big_integer s0 = 1, s1 = 0;
+        if (x < y) {
+            std::swap(x, y);
+            std::swap(s0, s1);
+        }
+        while (y != 0) {
+            if (coefficient == nullptr && limb_count(x) <= 2) {
+                return from_uint64(binary_gcd(bits_at(x, 0), bits_at(y, 0)));
+            }
+            gcd_matrix m = gcd_step(x, y, 0);
+            if (coefficient != nullptr) {
+                m.apply(s0, s1);
+            }
+        }
+        if (coefficient != nullptr) {
+            *coefficient = s0;
+        }
+        return x;
+    }
+}
+
+big_integer gcd(big_integer const &a, big_integer const &b) {
+    return gcd_impl(a < 0 ? -a : a, b < 0 ? -b : b, nullptr);
+}
+
+big_integer lcm(big_integer const &a, big_integer const &b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    big_integer res = a / gcd(a, b) * b;
+    return res < 0 ? -res : res;
+}
+
+big_integer ext_gcd(big_integer const &a, big_integer const &b, big_integer &x, big_integer &y) {
+    big_integer abs_a = a < 0 ? -a : a;
+    big_integer abs_b = b < 0 ? -b : b;
+    big_integer s;
+    big_integer g = gcd_impl(abs_a, abs_b, &s);
+    // g = s * |a| + t * |b|, t is exact
+    big_integer t = abs_b == 0 ? big_integer(0) : (g - s * abs_a) / abs_b;
+    x = a < 0 ? -s : s;
+    y = b < 0 ? -t : t;
+    return g;
+}
+
+big_integer mod_inverse(big_integer const &a, big_integer const &m) {
+    if (m <= 0) {
+        throw std::invalid_argument("mod_inverse: modulus must be positive");
+    }
+    big_integer x, y;
+    if (ext_gcd(a, m, x, y) != 1) {
+        if (m == 1) {
+            return 0;
+        }
+        throw std::domain_error("mod_inverse: not invertible");
+    }
+    x %= m;
+    return x < 0 ? x + m : x;
+}
+
+// divisors from this many limbs on go through a Barrett reciprocal instead of schoolbook division
+static const size_t BARRETT_DIVISION_THRESHOLD = 4096;
+
+namespace {
+    // a / d for 0 <= a < d * B^size(d), the shape of every Newton quotient below
+    big_integer root_quotient(big_integer const &a, big_integer const &d) {
+        big_integer q, r;
+        if (limb_count(d) >= BARRETT_DIVISION_THRESHOLD) {
+            barrett_context(d).divmod(a, q, r);
+        } else {
+            divmod_abs(a, d, q, r);
+        }
+        return q;
+    }
+
+    // r^k <= v
+    bool power_fits(uint64_t r, unsigned k, uint64_t v) {
+        uint128_t p = 1;
+        for (unsigned i = 0; i < k; i++) {
+            p *= r;
+            if (p > v) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t iroot_64(uint64_t v, unsigned k) {
+        auto r = static_cast<uint64_t>(std::pow(static_cast<long double>(v), 1.0L / k));
+        while (r > 0 && !power_fits(r, k, v)) {
+            r--;
+        }
+        while (power_fits(r + 1, k, v)) {
+            r++;
+        }
+        return r;
+    }
+
+    // floor(a^(1/k)) for a > 0 and k >= 2
+    big_integer iroot_abs(big_integer const &a, unsigned k) {
+        size_t bits = bit_length(a);
+        if (k >= bits) {
+            return 1;
+        }
+        if (bits <= 64) {
+            return from_uint64(iroot_64(bits_at(a, 0), k));
+        }
+        // the root of the leading half of the bits is good to half the digits of the answer,
+        // rounded up it lies above the true root and Newton descends from there in a step or two
+        size_t s = bits / (2 * k);
+        big_integer x;
+        if (s == 0) {
+            x = big_integer(1) << static_cast<int>(bits / k + 1);
+        } else {
+            x = (iroot_abs(a >> static_cast<int>(k * s), k) + 1) << static_cast<int>(s);
+        }
+        while (true) {
+            big_integer d = k == 2 ? x : pow(x, k - 1);
+            big_integer y = (x * big_integer(k - 1) + root_quotient(a, d)) / big_integer(k);
+            if (y >= x) {
+                return x;
+            }
+            x = y;
+        }
+    }
+
+    std::vector<bool> square_table(uint32_t m) {
+        std::vector<bool> table(m, false);
+        for (uint64_t i = 0; i < m; i++) {
+            table[i * i % m] = true;
+        }
+        return table;
+    }
+
+    // squares mod 64, 63, 65 and 11 let through less than 1% of the non-squares
+    bool may_be_square(big_integer const &a) {
+        static const std::vector<bool> mod64 = square_table(64), mod63 = square_table(63),
+                mod65 = square_table(65), mod11 = square_table(11);
+        if (!mod64[bits_at(a, 0) & 63]) {
+            return false;
+        }
+        uint64_t r = bits_at(a % big_integer(63 * 65 * 11), 0);
+        return mod63[r % 63] && mod65[r % 65] && mod11[r % 11];
+    }
+
+    uint64_t pow_mod_64(uint64_t b, uint64_t e, uint64_t m) {
+        uint64_t res = 1 % m;
+        b %= m;
+        while (e != 0) {
+            if (e & 1) {
+                res = static_cast<uint64_t>(static_cast<uint128_t>(res) * b % m);
+            }
+            b = static_cast<uint64_t>(static_cast<uint128_t>(b) * b % m);
+            e >>= 1;
+        }
+        return res;
+    }
+
+    bool is_prime_32(uint64_t q) {
+        if (q < 2) {
+            return false;
+        }
+        for (uint64_t d = 2; d * d <= q; d++) {
+            if (q % d == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // primes below n <= 2^32 by the sieve of Eratosthenes, n is wide so that every uint32_t + 1 fits
+    std::vector<uint32_t> primes_below(uint64_t n) {
+        std::vector<bool> composite(n, false);
+        std::vector<uint32_t> primes;
+        for (uint64_t i = 2; i < n; i++) {
+            if (composite[i]) {
+                continue;
+            }
+            primes.push_back(static_cast<uint32_t>(i));
+            for (uint64_t j = i * i; j < n; j += i) {
+                composite[j] = true;
+            }
+        }
+        return primes;
+    }
+
+    // a p-th power for an odd prime p is 0 or a p-th power residue modulo every prime
+    // q = 1 (mod p), that is r^((q - 1) / p) = 1; three such q reject all but about 1 / p^3
+    bool may_be_power(big_integer const &a, uint32_t p) {
+        if (p == 2) {
+            return may_be_square(a);
+        }
+        int checked = 0;
+        for (uint64_t q = 2 * uint64_t(p) + 1; checked < 3 && q < INT_MAX; q += 2 * p) {
+            if (!is_prime_32(q)) {
+                continue;
+            }
+            checked++;
+            uint64_t r = bits_at(a % big_integer(static_cast<int>(q)), 0);
+            if (r != 0 && pow_mod_64(r, (q - 1) / p, q) != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t trailing_zeros(big_integer const &a) {
+        size_t shift = 0;
+        while (bits_at(a, shift) == 0) {
+            shift += 64;
+        }
+        return shift + __builtin_ctzll(bits_at(a, shift));
+    }
+
+    // a = base^exp with the largest exp, for a >= 2
+    void perfect_power_abs(big_integer const &a, big_integer &base, uint64_t &exp) {
+        base = a;
+        exp = 1;
+        std::vector<uint32_t> primes = primes_below(bit_length(a) + 1);
+        // a root found for p is no q-th power for any q < p either, so the scan never restarts
+        for (size_t i = 0; i < primes.size();) {
+            uint32_t p = primes[i];
+            if (p > bit_length(base)) {
+                break;
+            }
+            size_t zeros = trailing_zeros(base);
+            if ((zeros != 0 && zeros % p != 0) || !may_be_power(base, p)) {
+                i++;
+                continue;
+            }
+            big_integer root = iroot_abs(base, p);
+            if (pow(root, p) != base) {
+                i++;
+                continue;
+            }
+            base = root;
+            exp *= p;
+        }
+    }
+}
+
+big_integer isqrt(big_integer const &a) {
+    return iroot(a, 2);
+}
+
+big_integer iroot(big_integer const &a, unsigned k) {
+    if (k == 0) {
+        throw std::invalid_argument("iroot: k must be positive");
+    }
+    if (a < 0 && k % 2 == 0) {
+        throw std::domain_error("iroot: even root of a negative number");
+    }
+    if (a == 0 || k == 1) {
+        return a;
+    }
+    if (a < 0) {
+        return -iroot_abs(-a, k);
+    }
+    return iroot_abs(a, k);
+}
+
+bool is_square(big_integer const &a) {
+    if (a < 0) {
+        return false;
+    }
+    if (a == 0 || !may_be_square(a)) {
+        return a == 0;
+    }
+    big_integer r = iroot_abs(a, 2);
+    return r * r == a;
+}
+
+bool perfect_power(big_integer const &a) {
+    big_integer base;
+    uint64_t exp;
+    return perfect_power(a, base, exp);
+}
+
+bool perfect_power(big_integer const &a, big_integer &base, uint64_t &exp) {
+    if (a == 0 || a == 1) {
+        base = a;
+        exp = 2;
+        return true;
+    }
+    if (a == -1) {
+        base = a;
+        exp = 3;
+        return true;
+    }
+    big_integer b;
+    uint64_t e;
+    perfect_power_abs(a < 0 ? -a : a, b, e);
+    if (a < 0) {
+        // only an odd exponent keeps the sign, the powers of two go into the base
+        uint64_t twos = e & -e;
+        if (twos != 1) {
+            b = pow(b, twos);
+            e /= twos;
+        }
+        b = -b;
+    }
+    if (e == 1) {
+        return false;
+    }
+    base = b;
+    exp = e;
+    return true;
+}
+
+// candidates are trial divided by the primes below 16 times their bit length, within these bounds
+static const uint32_t TRIAL_DIVISION_MIN = 2048;
+static const uint32_t TRIAL_DIVISION_MAX = 65536;
+
+namespace {
+    // odd primes below the largest trial division bound in increasing order, packed into
+    // products that fit a limb so that one short division pass serves several primes
+    struct prime_groups {
+        prime_groups() {
+            for (uint32_t p : primes_below(TRIAL_DIVISION_MAX)) {
+                if (p == 2) {
+                    continue;
+                }
+                if (products.empty() || products.back() > UINT32_MAX / p) {
+                    products.push_back(1);
+                    members.emplace_back();
+                }
+                products.back() *= p;
+                members.back().push_back(p);
+            }
+        }
+
+        std::vector<uint32_t> products;
+        std::vector<std::vector<uint32_t>> members;
+    };
+
+    // Jacobi symbol (a / m) for odd m > 0
+    int jacobi(uint64_t a, uint64_t m) {
+        int res = 1;
+        a %= m;
+        while (a != 0) {
+            while (a % 2 == 0) {
+                a /= 2;
+                if (m % 8 == 3 || m % 8 == 5) {
+                    res = -res;
+                }
+            }
+            std::swap(a, m);
+            if (a % 4 == 3 && m % 4 == 3) {
+                res = -res;
+            }
+            a %= m;
+        }
+        return m == 1 ? res : 0;
+    }
+
+    // (D / n) for a small odd D and odd n > 0, by reciprocity
+    int jacobi(int D, big_integer const &n) {
+        uint32_t d = D < 0 ? -D : D;
+        uint64_t n4 = bits_at(n, 0) & 3;
+        int res = jacobi(bits_at(n % big_integer(d), 0), d);
+        if (d % 4 == 3 && n4 == 3) {
+            res = -res;
+        }
+        if (D < 0 && n4 == 3) {
+            res = -res;
+        }
+        return res;
+    }
+
+    // strong Lucas test with Selfridge's parameters: the first D of 5, -7, 9, -11, ...
+    // with (D / n) = -1, P = 1 and Q = (1 - D) / 4; n must be odd and no square
+    bool strong_lucas(montgomery_ring &ring, big_integer const &n) {
+        int D = 5;
+        while (true) {
+            int j = jacobi(D, n);
+            if (j == -1) {
+                break;
+            }
+            if (j == 0 && n != big_integer(static_cast<uint32_t>(D < 0 ? -D : D))) {
+                return false;
+            }
+            D = D > 0 ? -(D + 2) : -D + 2;
+        }
+        big_integer k = n + 1;
+        size_t twos = trailing_zeros(k);
+        k >>= static_cast<int>(twos);
+
+        montgomery_context const &ctx = ring.ctx;
+        montgomery_context::scratch &s = ring.scratch;
+        // (x / 2) mod n for x in [0, n), the same in Montgomery form
+        auto half = [&n](big_integer &x) {
+            if (bits_at(x, 0) & 1) {
+                x += n;
+            }
+            x >>= 1;
+        };
+        big_integer d = ring.to_ring(D), q = ring.to_ring((1 - D) / 4);
+        big_integer u = ring.one(), v = ring.one(), qk = q, t;
+        // (U_k, V_k, Q^k) from k to 2k and on to 2k + 1 for a set bit
+        for (size_t i = bit_length(k) - 1; i-- > 0;) {
+            ring.mul(u, u, v);
+            ring.sqr(v, v);
+            ctx.sub(v, v, qk, s);
+            ctx.sub(v, v, qk, s);
+            ring.sqr(qk, qk);
+            if (bits_at(k, i) & 1) {
+                ring.mul(t, d, u);
+                ctx.add(u, u, v, s);
+                half(u);
+                ctx.add(v, t, v, s);
+                half(v);
+                ring.mul(qk, qk, q);
+            }
+        }
+        if (u == 0 || v == 0) {
+            return true;
+        }
+        for (size_t r = 1; r < twos; r++) {
+            ring.sqr(v, v);
+            ctx.sub(v, v, qk, s);
+            ctx.sub(v, v, qk, s);
+            if (v == 0) {
+                return true;
+            }
+            ring.sqr(qk, qk);
+        }
+        return false;
+    }
+}
+
+bool is_probable_prime(big_integer const &a) {
+    if (a < 2) {
+        return false;
+    }
+    if ((a.data()[0] & 1) == 0) {
+        return a == 2;
+    }
+    static const prime_groups groups;
+    size_t bound = std::min<size_t>(TRIAL_DIVISION_MAX, std::max<size_t>(TRIAL_DIVISION_MIN, 16 * bit_length(a)));
+    size_t used = 0;
+    while (used < groups.products.size() && groups.members[used][0] < bound) {
+        used++;
+    }
+    std::vector<uint32_t> rems(used);
+    limbs::mod_1s(rems.data(), a.data(), a.size(), groups.products.data(), rems.size());
+    for (size_t i = 0; i < rems.size(); i++) {
+        for (uint32_t p : groups.members[i]) {
+            if (rems[i] % p == 0) {
+                return a == big_integer(p);
+            }
+        }
+    }
+    if (a < big_integer(static_cast<uint32_t>(bound)) * big_integer(static_cast<uint32_t>(bound))) {
+        return true;
+    }
+    if (is_square(a)) {
+        return false;
+    }
+
+    // strong probable prime to base 2, with a - 1 = e * 2^twos
+    montgomery_ring ring(a);
+    big_integer e = a - 1;
+    size_t twos = trailing_zeros(e);
+    e >>= static_cast<int>(twos);
+    big_integer x = sliding_window(ring, big_integer(2), e.data(), bit_length(e));
+    if (x != 1 && x != a - 1) {
+        big_integer minus_one = ring.to_ring(a - 1);
+        x = ring.to_ring(x);
+        size_t r = 1;
+        for (; r < twos; r++) {
+            ring.sqr(x, x);
+            if (x == minus_one) {
+                break;
+            }
+        }
+        if (r == twos) {
+            return false;
+        }
+    }
+    return strong_lucas(ring, a);
+}
+
+std::vector<bool> is_probable_prime(std::vector<big_integer> const &candidates) {
+    std::vector<char> prime(candidates.size());
+    parallel_for(thread_pool::instance().get(), 0, candidates.size(), 1, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; i++) {
+            prime[i] = is_probable_prime(candidates[i]);
+        }
+    });
+    return std::vector<bool>(prime.begin(), prime.end());
+}
+
+namespace {
+    // factors multiplied together as long as they fit a limb
+    std::vector<uint32_t> pack_factors(std::vector<uint32_t> const &factors) {
+        std::vector<uint32_t> packed;
+        uint64_t acc = 1;
+        for (uint32_t f : factors) {
+            if (acc * f > UINT32_MAX) {
+                packed.push_back(static_cast<uint32_t>(acc));
+                acc = 1;
+            }
+            acc *= f;
+        }
+        if (acc != 1 || packed.empty()) {
+            packed.push_back(static_cast<uint32_t>(acc));
+        }
+        return packed;
+    }
+
+    // balanced product tree over one limb factors, the halves of a product of at least
+    // parallel_cutoff limbs run side by side on the pool
+    big_integer product(uint32_t const *f, size_t n, thread_pool *pool) {
+        if (n <= 8) {
+            big_integer res = f[0];
+            for (size_t i = 1; i < n; i++) {
+                res *= big_integer(f[i]);
+            }
+            return res;
+        }
+        big_integer low, high;
+        if (pool != nullptr && n >= thread_pool::parallel_cutoff()) {
+            thread_pool::task_group group(pool);
+            group.spawn([&] { low = product(f, n / 2, pool); });
+            high = product(f + n / 2, n - n / 2, pool);
+            group.wait();
+        } else {
+            low = product(f, n / 2, pool);
+            high = product(f + n / 2, n - n / 2, pool);
+        }
+        return low * high;
+    }
+
+    big_integer product(std::vector<uint32_t> const &factors) {
+        std::vector<uint32_t> packed = pack_factors(factors);
+        std::shared_ptr<thread_pool> pool;
+        if (packed.size() >= thread_pool::parallel_cutoff()) {
+            pool = thread_pool::instance();
+        }
+        return product(packed.data(), packed.size(), pool.get());
+    }
+
+    // prod p^e over odd primes, as (..((P_top)^2 * P_top-1)^2 ..) * P_0 where P_k is the
+    // product of the primes with bit k set in their exponent; the power of two is one shift
+    big_integer prime_power_product(std::vector<uint32_t> const &primes, std::vector<uint64_t> const &exps) {
+        uint64_t all = 0;
+        uint64_t twos = 0;
+        for (size_t i = 0; i < primes.size(); i++) {
+            if (primes[i] == 2) {
+                twos = exps[i];
+            } else {
+                all |= exps[i];
+            }
+        }
+        big_integer res = 1;
+        for (int k = all == 0 ? -1 : 63 - __builtin_clzll(all); k >= 0; k--) {
+            res *= res;
+            std::vector<uint32_t> factors;
+            for (size_t i = 0; i < primes.size(); i++) {
+                if (primes[i] != 2 && ((exps[i] >> k) & 1)) {
+                    factors.push_back(primes[i]);
+                }
+            }
+            if (!factors.empty()) {
+                res *= product(factors);
+            }
+        }
+        if (twos > static_cast<uint64_t>(INT_MAX)) {
+            throw std::length_error("result too large");
+        }
+        return res << static_cast<int>(twos);
+    }
+
+    // exponent of p in n! by Legendre's formula
+    uint64_t legendre(uint64_t n, uint64_t p) {
+        uint64_t e = 0;
+        while (n != 0) {
+            n /= p;
+            e += n;
+        }
+        return e;
+    }
+}
+
+big_integer factorial(uint32_t n) {
+    std::vector<uint32_t> primes = primes_below(uint64_t(n) + 1);
+    std::vector<uint64_t> exps(primes.size());
+    for (size_t i = 0; i < primes.size(); i++) {
+        exps[i] = legendre(n, primes[i]);
+    }
+    return prime_power_product(primes, exps);
+}
+
+big_integer binomial(uint32_t n, uint32_t k) {
+    if (k > n) {
+        return 0;
+    }
+    k = std::min(k, n - k);
+    if (k < n / 64) {
+        // the sieve up to n would cost more than the short falling product
+        std::vector<uint32_t> factors(k);
+        for (uint32_t i = 0; i < k; i++) {
+            factors[i] = n - i;
+        }
+        return product(factors) / factorial(k);
+    }
+    std::vector<uint32_t> primes = primes_below(uint64_t(n) + 1);
+    std::vector<uint64_t> exps(primes.size());
+    for (size_t i = 0; i < primes.size(); i++) {
+        exps[i] = legendre(n, primes[i]) - legendre(k, primes[i]) - legendre(n - k, primes[i]);
+    }
+    return prime_power_product(primes, exps);
+}
+
+big_integer primorial(uint32_t n) {
+    std::vector<uint32_t> primes = primes_below(uint64_t(n) + 1);
+    return primes.empty() ? big_integer(1) : product(primes);
+}
+
+namespace {
+    // f = F_n and g = F_(n-1) for n >= 1 by fast doubling on two squarings a step:
+    // F_(2k+1) = 4 F_k^2 - F_(k-1)^2 + 2 (-1)^k, F_(2k-1) = F_k^2 + F_(k-1)^2 and
+    // F_2k the difference. Every buffer, the squaring scratch included, is sized for F_n
+    // up front and reused in place.
+    void fibonacci_limbs(uint64_t n, std::vector<uint32_t> &f, size_t &fn, std::vector<uint32_t> &g, size_t &gn) {
+        // F_n < phi^n and log2(phi) < 0.6943
+        size_t cap = static_cast<size_t>(static_cast<double>(n) * 0.6943 / 32) + 3;
+        f.assign(cap, 0);
+        g.assign(cap, 0);
+        std::vector<uint32_t> a(2 * cap), b(2 * cap), scratch(limbs::sqr_scratch(cap));
+        f[0] = 1;
+        fn = gn = 1;
+        std::shared_ptr<thread_pool> pool;
+        if (cap / 2 >= thread_pool::parallel_cutoff()) {
+            pool = thread_pool::instance();
+        }
+        for (int i = 62 - __builtin_clzll(n); i >= 0; i--) {
+            bool odd_k = (n >> (i + 1)) & 1;
+            size_t cutoff = thread_pool::parallel_cutoff();
+            limbs::sqr(a.data(), f.data(), fn, scratch.data(), fn >= cutoff ? pool.get() : nullptr);
+            limbs::sqr(b.data(), g.data(), gn, scratch.data(), gn >= cutoff ? pool.get() : nullptr);
+            size_t an = limbs::normalized_size(a.data(), 2 * fn);
+            size_t bn = limbs::normalized_size(b.data(), 2 * gn);
+            g[an] = limbs::add(g.data(), a.data(), an, b.data(), bn);
+            f[an] = limbs::lshift(f.data(), a.data(), an, 2);
+            limbs::sub(f.data(), f.data(), an + 1, b.data(), bn);
+            if (odd_k) {
+                limbs::sub_1(f.data(), f.data(), an + 1, 2);
+            } else {
+                limbs::add_1(f.data(), f.data(), an + 1, 2);
+            }
+            if ((n >> i) & 1) {
+                limbs::sub_n(g.data(), f.data(), g.data(), an + 1);
+            } else {
+                limbs::sub_n(f.data(), f.data(), g.data(), an + 1);
+            }
+            fn = limbs::normalized_size(f.data(), an + 1);
+            gn = limbs::normalized_size(g.data(), an + 1);
+        }
+    }
+}
+
+big_integer fibonacci(uint64_t n) {
+    if (n == 0) {
+        return 0;
+    }
+    std::vector<uint32_t> f, g;
+    size_t fn, gn;
+    fibonacci_limbs(n, f, fn, g, gn);
+    big_integer res;
+    res.val.resize(fn);
+    std::copy(f.data(), f.data() + fn, res.val.data());
+    res.sign = 1;
+    res.shrink_to_fit();
+    return res;
+}
+
+big_integer lucas(uint64_t n) {
+    if (n == 0) {
+        return 2;
+    }
+    std::vector<uint32_t> f, g;
+    size_t fn, gn;
+    fibonacci_limbs(n, f, fn, g, gn);
+    // L_n = F_n + 2 F_(n-1)
+    uint32_t carry = limbs::lshift(g.data(), g.data(), gn, 1);
+    size_t n_limbs = std::max(fn, gn) + 1;
+    g[gn] = carry;
+    std::fill(f.data() + fn, f.data() + n_limbs, 0);
+    std::fill(g.data() + gn + 1, g.data() + n_limbs, 0);
+    limbs::add_n(f.data(), f.data(), g.data(), n_limbs);
+    big_integer res;
+    n_limbs = limbs::normalized_size(f.data(), n_limbs);
+    res.val.resize(n_limbs);
+    std::copy(f.data(), f.data() + n_limbs, res.val.data());
+    res.sign = 1;
+    res.shrink_to_fit();
+    return res;
+}
+
+// consecutive one limb moduli are served together from the remainder modulo their product
+static const size_t SMALL_MODULI_BLOCK = 32;
+
+namespace {
+    big_integer remainder(big_integer const &a, big_integer const &m) {
+        if (limb_count(m) >= BARRETT_DIVISION_THRESHOLD) {
+            return barrett_context(m).reduce(a);
+        }
+        big_integer q, r;
+        divmod_abs(a, m, q, r);
+        return r;
+    }
+
+    // product tree over the leaves in heap order, node 1 is the root; x is pushed down it
+    // one remainder per node, so every division is by a modulus about half its dividend
+    struct remainder_tree {
+        remainder_tree(std::vector<big_integer> const &leaves, thread_pool *pool)
+                : leaves(leaves), nodes(4 * leaves.size()), limbs_before(leaves.size() + 1, 0), pool(pool) {
+            for (size_t i = 0; i < leaves.size(); i++) {
+                limbs_before[i + 1] = limbs_before[i] + limb_count(leaves[i]);
+            }
+            build(1, 0, leaves.size());
+        }
+
+        // |x| mod leaves[i] for every i
+        std::vector<big_integer> reduce(big_integer const &x) const {
+            std::vector<big_integer> out(leaves.size());
+            descend(1, 0, leaves.size(), remainder(x < 0 ? -x : x, nodes[1]), out);
+            return out;
+        }
+
+    private:
+        // pool for the halves of a product of this many limbs
+        thread_pool *split_pool(size_t limbs) const {
+            return limbs >= thread_pool::parallel_cutoff() ? pool : nullptr;
+        }
+
+        void build(size_t node, size_t from, size_t to) {
+            if (to - from == 1) {
+                nodes[node] = leaves[from];
+                return;
+            }
+            size_t mid = from + (to - from) / 2;
+            thread_pool::task_group group(split_pool(limbs_before[to] - limbs_before[from]));
+            group.spawn([&] { build(2 * node, from, mid); });
+            build(2 * node + 1, mid, to);
+            group.wait();
+            nodes[node] = nodes[2 * node] * nodes[2 * node + 1];
+        }
+
+        void descend(size_t node, size_t from, size_t to, big_integer const &r, std::vector<big_integer> &out) const {
+            if (to - from == 1) {
+                out[from] = r;
+                return;
+            }
+            size_t mid = from + (to - from) / 2;
+            thread_pool::task_group group(split_pool(limb_count(nodes[node])));
+            group.spawn([&] { descend(2 * node, from, mid, remainder(r, nodes[2 * node]), out); });
+            descend(2 * node + 1, mid, to, remainder(r, nodes[2 * node + 1]), out);
+            group.wait();
+        }
+
+        std::vector<big_integer> const &leaves;
+        std::vector<big_integer> nodes;
+        std::vector<size_t> limbs_before;
+        thread_pool *pool;
+    };
+}
+
+std::vector<big_integer> remainders(big_integer const &x, std::vector<big_integer> const &moduli) {
+    std::vector<big_integer> res(moduli.size());
+    if (moduli.empty()) {
+        return res;
+    }
+    // a leaf is a single large modulus or the product of a block of one limb moduli
+    std::vector<big_integer> leaves;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (size_t i = 0; i < moduli.size();) {
+        if (moduli[i] <= 0) {
+            throw std::invalid_argument("remainders: moduli must be positive");
+        }
+        size_t j = i + 1;
+        if (moduli[i].size() == 1) {
+            while (j < moduli.size() && j - i < SMALL_MODULI_BLOCK && moduli[j] > 0 && moduli[j].size() == 1) {
+                j++;
+            }
+        }
+        leaves.push_back(moduli[i]);
+        for (size_t k = i + 1; k < j; k++) {
+            leaves.back() *= moduli[k];
+        }
+        ranges.emplace_back(i, j);
+        i = j;
+    }
+
+    std::shared_ptr<thread_pool> pool;
+    if (std::max(x.size(), leaves.size()) >= thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    std::vector<big_integer> leaf_rems = remainder_tree(leaves, pool.get()).reduce(x);
+
+    std::vector<uint32_t> divisors, rems;
+    for (size_t l = 0; l < leaves.size(); l++) {
+        size_t from = ranges[l].first, to = ranges[l].second;
+        if (to - from == 1) {
+            res[from] = leaf_rems[l];
+        } else {
+            divisors.clear();
+            for (size_t k = from; k < to; k++) {
+                divisors.push_back(moduli[k].data()[0]);
+            }
+            rems.resize(divisors.size());
+            big_integer const &r = leaf_rems[l];
+            limbs::mod_1s(rems.data(), r.data(), r.size(), divisors.data(), divisors.size());
+            for (size_t k = from; k < to; k++) {
+                res[k] = rems[k - from];
+            }
+        }
+    }
+    if (x < 0) {
+        for (size_t i = 0; i < res.size(); i++) {
+            if (res[i] != 0) {
+                res[i] = moduli[i] - res[i];
+            }
+        }
+    }
+    return res;
+}
+
+// terms summed by one task, fixed so that the chunks are the same on any pool
+static const size_t SUM_CHUNK = 256;
+
+big_integer parallel_sum(std::vector<big_integer> const &terms) {
+    size_t total = 0;
+    for (big_integer const &t : terms) {
+        total += limb_count(t);
+    }
+    std::shared_ptr<thread_pool> pool;
+    if (total >= thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    size_t chunks = (terms.size() + SUM_CHUNK - 1) / SUM_CHUNK;
+    std::vector<big_integer> partial(chunks);
+    parallel_for(pool.get(), 0, chunks, 1, [&](size_t from, size_t to) {
+        for (size_t k = from; k < to; k++) {
+            big_integer_accumulator acc;
+            size_t end = std::min(terms.size(), (k + 1) * SUM_CHUNK);
+            for (size_t i = k * SUM_CHUNK; i < end; i++) {
+                acc += terms[i];
+            }
+            partial[k] = acc.value();
+        }
+    });
+    big_integer_accumulator acc;
+    for (big_integer const &p : partial) {
+        acc += p;
+    }
+    return acc.value();
+}
+
+namespace {
+    // product of f[from, to), prefix[i] is the number of limbs in f[0, i)
+    big_integer product(std::vector<big_integer> const &f, std::vector<size_t> const &prefix,
+                        size_t from, size_t to, thread_pool *pool) {
+        if (to - from == 1) {
+            return f[from];
+        }
+        size_t half = prefix[from] + (prefix[to] - prefix[from]) / 2;
+        size_t mid = std::lower_bound(prefix.begin() + from + 1, prefix.begin() + to, half) - prefix.begin();
+        if (mid == to || (mid > from + 1 && half - prefix[mid - 1] < prefix[mid] - half)) {
+            mid--;
+        }
+        big_integer low, high;
+        if (pool != nullptr && prefix[to] - prefix[from] >= thread_pool::parallel_cutoff()) {
+            thread_pool::task_group group(pool);
+            group.spawn([&] { low = product(f, prefix, from, mid, pool); });
+            high = product(f, prefix, mid, to, pool);
+            group.wait();
+        } else {
+            low = product(f, prefix, from, mid, pool);
+            high = product(f, prefix, mid, to, pool);
+        }
+        return low * high;
+    }
+}
+
+big_integer parallel_product(std::vector<big_integer> const &factors) {
+    if (factors.empty()) {
+        return 1;
+    }
+    std::vector<size_t> prefix(factors.size() + 1, 0);
+    for (size_t i = 0; i < factors.size(); i++) {
+        if (factors[i] == 0) {
+            return 0;
+        }
+        prefix[i + 1] = prefix[i] + limb_count(factors[i]);
+    }
+    std::shared_ptr<thread_pool> pool;
+    if (prefix.back() >= thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    return product(factors, prefix, 0, factors.size(), pool.get());
+}
@@ -0,0 +1,93 @@
+#ifndef BIG_INTEGER_MATH_H
+#define BIG_INTEGER_MATH_H
+
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+
+// base^exp mod m in [0, m). Sliding window over a table of odd powers, in Montgomery
+// form for an odd m and through Barrett reduction for an even one.
+// Throws std::invalid_argument for m <= 0 or exp < 0.
+big_integer pow_mod(big_integer const &base, big_integer const &exp, big_integer const &mod);
+
+// base^exp with pow(0, 0) = 1. Left-to-right binary powering on the squaring kernel;
+// a power of two factor of the base turns into one shift and a one limb base is first
+// raised to the largest power that still fits a limb.
+big_integer pow(big_integer const &base, uint64_t exp);
+
+// number of significant bits of |a|, 0 for 0
+size_t bit_length(big_integer const &a);
+
+// non-negative, gcd(0, 0) = 0. Binary GCD on two limbs, Lehmer steps on 64-bit leading
+// digits above that and a recursive half-GCD on the leading halves for large operands.
+big_integer gcd(big_integer const &a, big_integer const &b);
+
+// non-negative, 0 if either operand is 0
+big_integer lcm(big_integer const &a, big_integer const &b);
+
+// returns g = gcd(a, b) and sets x, y with a * x + b * y = g
+big_integer ext_gcd(big_integer const &a, big_integer const &b, big_integer &x, big_integer &y);
+
+// x in [0, m) with a * x = 1 (mod m). Throws std::invalid_argument for m <= 0
+// and std::domain_error when a and m are not coprime.
+big_integer mod_inverse(big_integer const &a, big_integer const &m);
+
+// floor(sqrt(a)); throws std::domain_error for a < 0
+big_integer isqrt(big_integer const &a);
+
+// the k-th root rounded toward zero. Newton iteration seeded from the root of the leading
+// half of the bits, which itself bottoms out in a floating point root of the top 64 bits.
+// Throws std::invalid_argument for k == 0 and std::domain_error for an even root of a < 0.
+big_integer iroot(big_integer const &a, unsigned k);
+
+// whether a = b^2; residues modulo 64, 63, 65 and 11 reject most non-squares before any root
+bool is_square(big_integer const &a);
+
+// whether a = b^k for some k >= 2, 0, 1 and -1 included. base and exp receive the
+// representation with the largest k; candidates for each prime k are screened by
+// k-th power residues modulo small primes before a root is taken.
+bool perfect_power(big_integer const &a);
+
+bool perfect_power(big_integer const &a, big_integer &base, uint64_t &exp);
+
+// Baillie-PSW: trial division by the primes below 16 times the bit length (2048 to 65536)
+// in one multi-prime short division pass, then a strong base 2 Miller-Rabin test and a strong Lucas test, both on a single
+// Montgomery context. No composite passing it is known. Values below 2 are not prime.
+bool is_probable_prime(big_integer const &a);
+
+// is_probable_prime of every candidate, candidates are spread over the thread pool
+std::vector<bool> is_probable_prime(std::vector<big_integer> const &candidates);
+
+// n!, from the prime factorisation: Legendre exponents of the odd primes combined by
+// squaring over balanced product trees, the power of two as one final shift.
+// Trees of at least parallel_cutoff limbs split across the thread pool.
+big_integer factorial(uint32_t n);
+
+// n choose k, 0 for k > n. Kummer exponents over the primes up to n like factorial,
+// or a product tree of n (n - 1) ... (n - k + 1) divided by k! when k is much smaller than n.
+big_integer binomial(uint32_t n, uint32_t k);
+
+// product of the primes up to n
+big_integer primorial(uint32_t n);
+
+// F_n with F_0 = 0, F_1 = 1, by fast doubling on the squaring kernel
+big_integer fibonacci(uint64_t n);
+
+// L_n with L_0 = 2, L_1 = 1
+big_integer lucas(uint64_t n);
+
+// x mod m_i in [0, m_i) for every modulus. x is pushed down a product tree of the
+// moduli; runs of one limb moduli share a leaf and are finished off together by a
+// multi-divisor short division. Throws std::invalid_argument unless all moduli are positive.
+std::vector<big_integer> remainders(big_integer const &x, std::vector<big_integer> const &moduli);
+
+// sum of the range, in fixed chunks of carry-save accumulation spread over the thread pool
+// and folded in order, so the work done does not depend on the number of threads
+big_integer parallel_sum(std::vector<big_integer> const &terms);
+
+// product of the range, 1 for an empty one. A balanced tree split where the limb count
+// halves keeps the factors of every product of similar size; subtrees of at least
+// parallel_cutoff limbs run side by side on the thread pool.
+big_integer parallel_product(std::vector<big_integer> const &factors);
+
+#endif //BIG_INTEGER_MATH_H
@@ -0,0 +1,425 @@
+#include "big_integer_radix.h"
+#include "big_integer_impl.h"
+#include "big_integer_math.h"
+#include "big_integer_stats.h"
+#include "limb_ops.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+static char const DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+// operator<< converts values of up to this many characters on the stack
+static const size_t STREAM_BUFFER = 512;
+// operator>> parses digits this many at a time
+static const size_t STREAM_CHUNK = 1024;
+
+namespace {
+    void check_base(unsigned base) {
+        if (base < 2 || base > 36) {
+            throw std::invalid_argument("radix: base must be in [2, 36]");
+        }
+    }
+
+    // log2 of a power of two base, 0 otherwise
+    unsigned pow2_bits(unsigned base) {
+        return (base & (base - 1)) == 0 ? __builtin_ctz(base) : 0;
+    }
+
+    // value of a digit character, 36 for anything else
+    unsigned digit_value(char c) {
+        if (c >= '0' && c <= '9') {
+            return static_cast<unsigned>(c - '0');
+        }
+        if (c >= 'a' && c <= 'z') {
+            return static_cast<unsigned>(c - 'a' + 10);
+        }
+        if (c >= 'A' && c <= 'Z') {
+            return static_cast<unsigned>(c - 'A' + 10);
+        }
+        return 36;
+    }
+
+    // largest power of the base that fits a limb and its exponent
+    uint32_t chunk_power(unsigned base, size_t &digits) {
+        uint64_t power = base;
+        digits = 1;
+        while (power * base <= UINT32_MAX) {
+            power *= base;
+            digits++;
+        }
+        return static_cast<uint32_t>(power);
+    }
+
+    // eight hex digits of v, most significant first: the nibbles are spread one a byte
+    // and turned into characters by SWAR arithmetic on all eight bytes at once
+    void write_hex_limb(char *out, uint32_t v) {
+        uint64_t x = v;
+        x = (x | x << 16) & 0x0000ffff0000ffffull;
+        x = (x | x << 8) & 0x00ff00ff00ff00ffull;
+        x = (x | x << 4) & 0x0f0f0f0f0f0f0f0full;
+        uint64_t letters = ((x + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+        x += 0x3030303030303030ull + letters * ('a' - '0' - 10);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        x = __builtin_bswap64(x);
+#endif
+        std::memcpy(out, &x, 8);
+    }
+
+    // the count lowest digits of |x| in base 2^bits, written backwards from end
+    void write_pow2(big_integer_view x, unsigned bits, char *end, size_t count) {
+        uint32_t const *a = x.data();
+        size_t n = x.size();
+        size_t next = 0;
+        if (bits == 4) {
+            for (; next + 1 < n; next++) {
+                end -= 8;
+                write_hex_limb(end, a[next]);
+            }
+            count -= 8 * next;
+        }
+        uint64_t mask = (uint64_t(1) << bits) - 1;
+        uint64_t window = 0;
+        unsigned have = 0;
+        for (size_t k = 0; k < count; k++) {
+            if (have < bits) {
+                if (next < n) {
+                    window |= uint64_t(a[next++]) << have;
+                }
+                have += 32;
+            }
+            *--end = DIGITS[window & mask];
+            window >>= bits;
+            have -= bits;
+        }
+    }
+
+    // the digits of |x| != 0 into [first, last), their end or nullptr when they do not fit
+    char *write_generic(big_integer_view x, unsigned base, char *first, char *last) {
+        size_t chunk;
+        uint32_t power = chunk_power(base, chunk);
+        std::vector<uint32_t> tmp(x.data(), x.data() + x.size());
+        size_t n = tmp.size();
+        std::string digits;
+        while (n > 1 || tmp[0] != 0) {
+            uint32_t rem = limbs::divrem_1(tmp.data(), tmp.data(), n, power);
+            n = limbs::normalized_size(tmp.data(), n);
+            for (size_t i = 0; i < chunk; i++) {
+                digits += DIGITS[rem % base];
+                rem /= base;
+            }
+        }
+        while (digits.back() == '0') {
+            digits.pop_back();
+        }
+        if (digits.size() > static_cast<size_t>(last - first)) {
+            return nullptr;
+        }
+        return std::copy(digits.rbegin(), digits.rend(), first);
+    }
+
+    big_integer from_digits_pow2(char const *first, char const *last, unsigned bits) {
+        std::vector<uint32_t> res;
+        res.reserve(((last - first) * bits + 31) / 32);
+        uint64_t window = 0;
+        unsigned have = 0;
+        while (last != first) {
+            window |= uint64_t(digit_value(*--last)) << have;
+            have += bits;
+            if (have >= 32) {
+                res.push_back(static_cast<uint32_t>(window));
+                window >>= 32;
+                have -= 32;
+            }
+        }
+        res.push_back(static_cast<uint32_t>(window));
+        return big_integer(big_integer_view(1, res.data(), res.size()));
+    }
+
+    big_integer from_digits_generic(char const *first, char const *last, unsigned base) {
+        size_t chunk;
+        uint32_t power = chunk_power(base, chunk);
+        std::vector<uint32_t> res(1, 0);
+        while (first != last) {
+            size_t len = std::min<size_t>(chunk, last - first);
+            uint32_t value = 0;
+            uint32_t scale = 1;
+            for (size_t i = 0; i < len; i++) {
+                value = value * base + digit_value(*first++);
+                scale *= base;
+            }
+            if (len != chunk) {
+                power = scale;
+            }
+            uint32_t carry = limbs::mul_1(res.data(), res.data(), res.size(), power);
+            carry += limbs::add_1(res.data(), res.data(), res.size(), value);
+            if (carry != 0) {
+                res.push_back(carry);
+            }
+        }
+        return big_integer(big_integer_view(1, res.data(), res.size()));
+    }
+
+    std::string convert(big_integer_view x, unsigned base) {
+        std::string res(max_chars(x, base), '\0');
+        res.resize(to_chars(&res[0], &res[0] + res.size(), x, base).ptr - res.data());
+        return res;
+    }
+}
+
+size_t max_chars(big_integer_view x, unsigned base) {
+    check_base(base);
+    size_t bits = bit_length(x);
+    size_t sign = x.sign() < 0;
+    unsigned b = pow2_bits(base);
+    if (b != 0) {
+        return sign + std::max<size_t>(1, (bits + b - 1) / b);
+    }
+    // floor(bits * log_base 2) + 1 digits, one more for the rounding of the logarithm
+    return sign + static_cast<size_t>(bits * (std::log(2.0) / std::log(base))) + 2;
+}
+
+to_chars_result to_chars(char *first, char *last, big_integer_view x, unsigned base) {
+    check_base(base);
+    if (x.size() == 0) {
+        if (first == last) {
+            return {last, std::errc::value_too_large};
+        }
+        *first = '0';
+        return {first + 1, std::errc()};
+    }
+    char *digits = first;
+    if (x.sign() < 0) {
+        if (first == last) {
+            return {last, std::errc::value_too_large};
+        }
+        *digits++ = '-';
+    }
+    char *end;
+    unsigned bits = pow2_bits(base);
+    if (bits != 0) {
+        size_t count = (bit_length(x) + bits - 1) / bits;
+        end = count <= static_cast<size_t>(last - digits) ? digits + count : nullptr;
+        if (end != nullptr) {
+            write_pow2(x, bits, end, count);
+        }
+    } else if (base == 10) {
+        end = write_decimal_chars(x, digits, last);
+    } else {
+        end = write_generic(x, base, digits, last);
+    }
+    if (end == nullptr) {
+        return {last, std::errc::value_too_large};
+    }
+    return {end, std::errc()};
+}
+
+from_chars_result from_chars(char const *first, char const *last, big_integer &x, unsigned base) {
+    check_base(base);
+    BIGINT_STATS_CALL(PARSE, static_cast<size_t>(last - first) / 9 + 1);
+    char const *digits = first;
+    bool negative = digits != last && *digits == '-';
+    if (negative) {
+        digits++;
+    }
+    char const *end = digits;
+    while (end != last && digit_value(*end) < base) {
+        end++;
+    }
+    if (end == digits) {
+        return {first, std::errc::invalid_argument};
+    }
+    unsigned bits = pow2_bits(base);
+    big_integer res;
+    if (base == 10) {
+        res = parse_decimal(digits, end - digits);
+    } else if (bits != 0) {
+        res = from_digits_pow2(digits, end, bits);
+    } else {
+        res = from_digits_generic(digits, end, base);
+    }
+    x = negative ? -res : res;
+    return {end, std::errc()};
+}
+
+std::string to_string(big_integer_view a) {
+    BIGINT_STATS_CALL(TO_STRING, std::max<size_t>(1, a.size()));
+    return convert(a, 10);
+}
+
+std::string to_string(big_integer_view x, unsigned base) {
+    check_base(base);
+    return base == 10 ? to_string(x) : convert(x, base);
+}
+
+big_integer from_string(std::string const &str, unsigned base) {
+    char const *first = str.data();
+    char const *last = first + str.size();
+    if (last - first > 1 && first[0] == '+' && first[1] != '-') {
+        first++;
+    }
+    big_integer res;
+    from_chars_result r = from_chars(first, last, res, base);
+    if (r.ec != std::errc() || r.ptr != last) {
+        throw std::invalid_argument("from_string: not a digit of the base at pos:" + std::to_string(r.ptr - str.data()));
+    }
+    return res;
+}
+
+std::ostream &operator<<(std::ostream &os, big_integer_view a) {
+    std::ios_base::fmtflags flags = os.flags();
+    unsigned base = 10;
+    if ((flags & std::ios_base::basefield) == std::ios_base::hex) {
+        base = 16;
+    } else if ((flags & std::ios_base::basefield) == std::ios_base::oct) {
+        base = 8;
+    }
+    char small[STREAM_BUFFER];
+    std::vector<char> large;
+    size_t size = max_chars(a, base);
+    char *first = small;
+    if (size > sizeof(small)) {
+        large.resize(size);
+        first = large.data();
+    }
+    char *last = to_chars(first, first + size, a, base).ptr;
+    if ((flags & std::ios_base::uppercase) != 0) {
+        std::transform(first, last, first, [](char c) { return static_cast<char>(std::toupper(c)); });
+    }
+    std::streamsize len = last - first;
+    std::streamsize pad = std::max<std::streamsize>(0, os.width() - len);
+    os.width(0);
+    bool left = (flags & std::ios_base::adjustfield) == std::ios_base::left;
+    if (!left) {
+        std::fill_n(std::ostreambuf_iterator<char>(os), pad, os.fill());
+    }
+    os.write(first, len);
+    if (left) {
+        std::fill_n(std::ostreambuf_iterator<char>(os), pad, os.fill());
+    }
+    return os;
+}
+
+namespace {
+    // Digits arriving most significant first, folded like a binary counter: equal sized
+    // blocks merge into one twice the size, so every product is balanced and only one
+    // chunk of text is ever held.
+    struct digit_blocks {
+        explicit digit_blocks(unsigned base) : base(base), bits(pow2_bits(base)) {}
+
+        void push(big_integer value, size_t digits) {
+            blocks.push_back({std::move(value), digits});
+            while (blocks.size() >= 2 && blocks[blocks.size() - 2].digits == blocks.back().digits) {
+                block low = std::move(blocks.back());
+                blocks.pop_back();
+                append(blocks.back(), low);
+            }
+        }
+
+        big_integer value() {
+            if (blocks.empty()) {
+                return 0;
+            }
+            // block sizes fall from the bottom up, each one is a single chunk power
+            for (size_t i = 1; i < blocks.size(); i++) {
+                append(blocks[0], blocks[i]);
+            }
+            return blocks[0].value;
+        }
+
+    private:
+        struct block {
+            big_integer value;
+            size_t digits;
+        };
+
+        void append(block &high, block const &low) {
+            if (bits != 0) {
+                high.value <<= static_cast<int>(bits * low.digits);
+            } else {
+                high.value *= power(low.digits);
+            }
+            high.value += low.value;
+            high.digits += low.digits;
+        }
+
+        // base^digits, the powers base^(STREAM_CHUNK * 2^k) of whole blocks by repeated squaring
+        big_integer power(size_t digits) {
+            if (digits < STREAM_CHUNK) {
+                return pow(big_integer(base), digits);
+            }
+            size_t k = __builtin_ctzll(digits / STREAM_CHUNK);
+            if (chunk_powers.empty()) {
+                chunk_powers.push_back(pow(big_integer(base), STREAM_CHUNK));
+            }
+            while (chunk_powers.size() <= k) {
+                big_integer const &last = chunk_powers.back();
+                chunk_powers.push_back(last * last);
+            }
+            return chunk_powers[k];
+        }
+
+        unsigned base;
+        unsigned bits;
+        std::vector<block> blocks;
+        std::vector<big_integer> chunk_powers;
+    };
+}
+
+std::istream &operator>>(std::istream &is, big_integer &x) {
+    std::istream::sentry sentry(is);
+    if (!sentry) {
+        return is;
+    }
+    unsigned base = 10;
+    if ((is.flags() & std::ios_base::basefield) == std::ios_base::hex) {
+        base = 16;
+    } else if ((is.flags() & std::ios_base::basefield) == std::ios_base::oct) {
+        base = 8;
+    }
+    std::streambuf *buf = is.rdbuf();
+    typedef std::char_traits<char> traits;
+    traits::int_type c = buf->sgetc();
+    bool negative = false;
+    if (c == '-' || c == '+') {
+        negative = c == '-';
+        c = buf->snextc();
+    }
+    digit_blocks blocks(base);
+    char chunk[STREAM_CHUNK];
+    size_t len = 0;
+    bool any = false;
+    while (!traits::eq_int_type(c, traits::eof()) && digit_value(traits::to_char_type(c)) < base) {
+        chunk[len++] = traits::to_char_type(c);
+        any = true;
+        if (len == STREAM_CHUNK) {
+            big_integer value;
+            from_chars(chunk, chunk + len, value, base);
+            blocks.push(std::move(value), len);
+            len = 0;
+        }
+        c = buf->snextc();
+    }
+    std::ios_base::iostate state = std::ios_base::goodbit;
+    if (traits::eq_int_type(c, traits::eof())) {
+        state |= std::ios_base::eofbit;
+    }
+    if (!any) {
+        is.setstate(state | std::ios_base::failbit);
+        return is;
+    }
+    if (len != 0) {
+        big_integer value;
+        from_chars(chunk, chunk + len, value, base);
+        blocks.push(std::move(value), len);
+    }
+    big_integer res = blocks.value();
+    x = negative ? -res : res;
+    is.setstate(state);
+    return is;
+}
@@ -0,0 +1,44 @@
+#ifndef BIG_INTEGER_RADIX_H
+#define BIG_INTEGER_RADIX_H
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include "big_integer.h"
+#include "big_integer_view.h"
+
+// std::to_chars_result and std::from_chars_result of C++17
+struct to_chars_result {
+    char *ptr;
+    std::errc ec;
+};
+
+struct from_chars_result {
+    char const *ptr;
+    std::errc ec;
+};
+
+// All of these take a base from 2 to 36 and throw std::invalid_argument for any other.
+// Digits above 9 are lower case letters on output and either case on input.
+
+// an upper bound on the characters to_chars writes for x, the sign included, from the bit length alone
+size_t max_chars(big_integer_view x, unsigned base = 10);
+
+// writes x to [first, last) with a leading '-' for negatives; ptr is the end of the
+// characters, or last with std::errc::value_too_large when they do not fit. Bases 2, 4, 8,
+// 16 and 32 are one linear pass over the bits, hex eight digits a limb at once; base 10 is
+// the divide-and-conquer decimal conversion, other bases repeated short division. Values
+// of up to 48 limbs and all power of two bases are converted without allocation.
+to_chars_result to_chars(char *first, char *last, big_integer_view x, unsigned base = 10);
+
+// parses an optional '-' and the longest run of digits of the base that follows into x;
+// ptr is past the digits, or first with std::errc::invalid_argument and x unchanged
+// when there are none
+from_chars_result from_chars(char const *first, char const *last, big_integer &x, unsigned base = 10);
+
+std::string to_string(big_integer_view x, unsigned base);
+
+// an optional sign and digits of the base, nothing else; throws std::invalid_argument otherwise
+big_integer from_string(std::string const &str, unsigned base);
+
+#endif //BIG_INTEGER_RADIX_H
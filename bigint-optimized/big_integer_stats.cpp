@@ -0,0 +1,65 @@
+#include "big_integer_stats.h"
+#include <atomic>
+
+static std::atomic<uint64_t> total_counters[big_integer_stats::COUNTER_COUNT];
+static std::atomic<uint64_t> total_calls[big_integer_stats::OPERATION_COUNT];
+static std::atomic<uint64_t> total_sizes[big_integer_stats::OPERATION_COUNT][big_integer_stats::BUCKET_COUNT];
+static thread_local size_t depth = 0;
+
+bool big_integer_stats::enabled() {
+#ifdef BIGINT_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+big_integer_stats big_integer_stats::snapshot() {
+    big_integer_stats res;
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        res.counters[i] = total_counters[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < OPERATION_COUNT; i++) {
+        res.calls[i] = total_calls[i].load(std::memory_order_relaxed);
+        for (size_t j = 0; j < BUCKET_COUNT; j++) {
+            res.sizes[i][j] = total_sizes[i][j].load(std::memory_order_relaxed);
+        }
+    }
+    return res;
+}
+
+void big_integer_stats::reset() {
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        total_counters[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < OPERATION_COUNT; i++) {
+        total_calls[i].store(0, std::memory_order_relaxed);
+        for (size_t j = 0; j < BUCKET_COUNT; j++) {
+            total_sizes[i][j].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t big_integer_stats::bucket(size_t limbs) {
+    size_t res = 0;
+    while (limbs > 1 && res + 1 < BUCKET_COUNT) {
+        limbs >>= 1;
+        res++;
+    }
+    return res;
+}
+
+void big_integer_stats::count(counter c) {
+    total_counters[c].fetch_add(1, std::memory_order_relaxed);
+}
+
+big_integer_stats::scope::scope(operation op, size_t limbs) {
+    if (depth++ == 0) {
+        total_calls[op].fetch_add(1, std::memory_order_relaxed);
+        total_sizes[op][bucket(limbs)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+big_integer_stats::scope::~scope() {
+    depth--;
+}
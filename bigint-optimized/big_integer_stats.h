@@ -0,0 +1,73 @@
+#ifndef BIG_INTEGER_STATS_H
+#define BIG_INTEGER_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Hot path counters, compiled in only with -DBIGINT_STATS (cmake -DBIGINT_STATS=ON).
+// Without it the hooks expand to nothing and snapshot() stays all zeros.
+struct big_integer_stats {
+    enum counter {
+        ALLOCATIONS,
+        FREES,
+        REALLOCATIONS,
+        UNSHARES,
+        SHARED_COPIES,
+        COUNTER_COUNT
+    };
+
+    enum operation {
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        MOD,
+        AND,
+        OR,
+        XOR,
+        SHL,
+        SHR,
+        TO_STRING,
+        PARSE,
+        OPERATION_COUNT
+    };
+
+    // bucket i counts calls whose largest operand has [2^i, 2^(i + 1)) limbs
+    static size_t constexpr BUCKET_COUNT = 32;
+
+    uint64_t counters[COUNTER_COUNT];
+    uint64_t calls[OPERATION_COUNT];
+    uint64_t sizes[OPERATION_COUNT][BUCKET_COUNT];
+
+    static bool enabled();
+
+    static big_integer_stats snapshot();
+
+    static void reset();
+
+    static size_t bucket(size_t limbs);
+
+    static void count(counter c);
+
+    // counts only the outermost operation of a thread, so that % calling / and *
+    // is reported as a single MOD
+    struct scope {
+        scope(operation op, size_t limbs);
+
+        ~scope();
+
+        scope(scope const &) = delete;
+
+        scope &operator=(scope const &) = delete;
+    };
+};
+
+#ifdef BIGINT_STATS
+#define BIGINT_STATS_COUNT(c) big_integer_stats::count(big_integer_stats::c)
+#define BIGINT_STATS_CALL(op, limbs) big_integer_stats::scope stats_scope_(big_integer_stats::op, (limbs))
+#else
+#define BIGINT_STATS_COUNT(c) static_cast<void>(0)
+#define BIGINT_STATS_CALL(op, limbs) static_cast<void>(0)
+#endif
+
+#endif //BIG_INTEGER_STATS_H
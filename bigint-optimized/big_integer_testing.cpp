@@ -1,13 +1,32 @@
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <limits>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <utility>
 #include <gtest/gtest.h>
 
+#include "barrett_context.h"
 #include "big_integer.h"
+#include "big_integer_accumulator.h"
+#include "big_integer_bytes.h"
+#include "big_integer_expr.h"
 #include "big_integer_gmp.h"
+#include "big_integer_math.h"
+#include "big_integer_radix.h"
+#include "big_integer_stats.h"
+#include "big_integer_view.h"
+#include "montgomery_context.h"
+#include "rns_integer.h"
+#include "thread_pool.h"
 
 TEST(correctness, two_plus_two) {
   EXPECT_EQ(big_integer(4), big_integer(2) + big_integer(2));
@@ -744,6 +763,71 @@ TEST(correctness_random, mul) {
   }
 }
 
+TEST(correctness_random, mul_large) {
+  std::default_random_engine rng(7);
+  for (size_t bits : {1000, 3000, 30000, 100000, 200000}) {
+    big_integer_gmp a, b;
+    a.random(bits, rng);
+    b.random(bits / 3 + 17, rng);
+    big_integer A = big_integer(to_string(a));
+    big_integer B = big_integer(to_string(b));
+    EXPECT_EQ(to_string(a * b), to_string(A * B));
+    EXPECT_EQ(to_string(b * a), to_string(B * A));
+    EXPECT_EQ(to_string(a * a), to_string(A * A));
+    big_integer C = A;
+    C *= C;
+    EXPECT_EQ(to_string(a * a), to_string(C));
+  }
+}
+
+TEST(correctness_random, decimal_large) {
+  std::default_random_engine rng(11);
+  for (size_t bits : {1000, 5000, 30000, 200000, 700000}) {
+    big_integer_gmp a;
+    a.random(bits, rng);
+    std::string s = to_string(a);
+    EXPECT_EQ(s, to_string(big_integer(s)));
+    if (s[0] == '-')
+      s.erase(0, 1);
+    EXPECT_EQ("-" + s, to_string(big_integer("-" + s)));
+    std::string padded = "000000000000" + s;
+    EXPECT_EQ(s, to_string(big_integer(padded)));
+  }
+  big_integer power = 1;
+  for (int i = 0; i != 3000; ++i)
+    power *= 10;
+  EXPECT_EQ("1" + std::string(3000, '0'), to_string(power));
+  EXPECT_EQ(std::string(3000, '9'), to_string(power - 1));
+  // around the chunk powers 10^(9 * 2^k) the top chunk changes length and zero chunks appear
+  for (size_t digits : {576, 1152, 2304, 4608}) {
+    big_integer p = pow(big_integer(10), digits);
+    EXPECT_EQ(std::string(digits, '9'), to_string(p - 1));
+    EXPECT_EQ("1" + std::string(digits, '0'), to_string(p));
+    EXPECT_EQ("1" + std::string(digits - 1, '0') + "1", to_string(p + 1));
+    EXPECT_EQ("-1" + std::string(2 * digits - 1, '0') + "7", to_string(-(p * p + 7)));
+    EXPECT_EQ("123" + std::string(digits + 8, '0'), to_string(p * big_integer("12300000000")));
+  }
+  EXPECT_EQ(power, big_integer("1" + std::string(3000, '0')));
+}
+
+TEST(correctness, mul_all_ones) {
+  for (int limbs : {31, 32, 100, 1600, 5000}) {
+    big_integer ones = (big_integer(1) << (32 * limbs)) - 1;
+    big_integer expected = (big_integer(1) << (64 * limbs)) - (big_integer(1) << (32 * limbs + 1)) + 1;
+    EXPECT_EQ(expected, ones * ones);
+    EXPECT_EQ(expected, ones * (ones + 0));
+    EXPECT_EQ(ones * (ones - 1), ones * ones - ones);
+  }
+}
+
+TEST(correctness, div_quotient_estimate) {
+  big_integer a("617595320724122471553189287247587273887298545764719389148129601242315761020301866933488111025859233442459286087942922285847735292695494451231185018183463964161769516878022243200558591896639656220166434854116143273439532718689938334326043333283873798331218689488196127481812867152729362289871038476128");
+  big_integer b = (big_integer(1) << 521) - 1;
+  EXPECT_EQ(big_integer("89965553436628472493192505330414830460465728178417988288215787926669319019384566784085498160068554128506688520253492126784334987493045325500577"), a / b);
+  EXPECT_EQ(1, a % b);
+  EXPECT_EQ(-1, -a % b);
+}
+
 TEST(correctness_random, div) {
   std::default_random_engine rng(322);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -835,3 +919,1393 @@ TEST(correctness_twos_complement, all_ones) {
 
   EXPECT_EQ(to_string(gmp_ans), to_string(your_ans));
 }
+
+namespace {
+std::string random_digits(size_t digits) {
+  std::mt19937 rng(digits);
+  std::string result(digits, '0');
+  result[0] = static_cast<char>('1' + rng() % 9);
+  for (size_t i = 1; i != digits; ++i)
+    result[i] = static_cast<char>('0' + rng() % 10);
+  return result;
+}
+
+// timings of sanitized debug builds only catch gross regressions,
+// there is no point in spending minutes on full-size operands
+#ifdef NDEBUG
+size_t const performance_scale = 1;
+#else
+size_t const performance_scale = 16;
+#endif
+
+// operand size of the linear-time checks: from 2^20 limbs on, the doubled operands and results
+// no longer fit the last level cache and the ratio measures memory bandwidth instead
+size_t const linear_limbs = 1 << 18;
+
+// doubles a random seed instead of building limb by limb to keep the setup linear
+big_integer random_limbs(size_t limbs) {
+  std::mt19937 rng(limbs);
+  big_integer result = static_cast<uint32_t>(rng() | 1);
+  for (size_t size = 1; size < limbs; size *= 2) {
+    size_t low = std::min(size, limbs - size);
+    big_integer tail = result >> static_cast<int>(32 * (size - low));
+    result = (result << static_cast<int>(32 * low)) + (tail ^ static_cast<int>(rng() >> 1));
+  }
+  return result;
+}
+
+// best of three runs, long runs are noisy enough on their own
+double best_time(std::function<void()> const& f) {
+  double best = std::numeric_limits<double>::max();
+  double total = 0;
+  for (size_t i = 0; i != 3 && total < 0.5; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+    total += elapsed.count();
+  }
+  return best;
+}
+
+// prepare(n) builds operands of size n outside of the timed region
+// and returns the operation to time. A real complexity regression fails
+// every attempt, a noisy neighbour rarely spoils all three.
+void expect_growth(size_t n, double exponent,
+                   std::function<std::function<void()>(size_t)> const& prepare) {
+  std::function<void()> small_op = prepare(n);
+  std::function<void()> large_op = prepare(2 * n);
+  double bound = std::pow(2.0, exponent) * 1.5;
+  double small = 0, large = 0;
+  for (size_t attempt = 0; attempt != 3; ++attempt) {
+    small = best_time(small_op);
+    large = best_time(large_op);
+    if (large <= small * bound)
+      return;
+  }
+  ADD_FAILURE() << "size " << n << ": " << small << "s, size " << 2 * n << ": " << large
+                << "s, expected growth at most " << bound;
+}
+}
+
+TEST(performance, to_string) {
+  expect_growth(100000 / performance_scale, 1.6, [](size_t n) {
+    big_integer a(random_digits(n));
+    return [a] { EXPECT_FALSE(to_string(a).empty()); };
+  });
+}
+
+TEST(performance, parse) {
+  expect_growth(100000 / performance_scale, 1.6, [](size_t n) {
+    std::string s = random_digits(n);
+    return [s] { EXPECT_NE(0, big_integer(s)); };
+  });
+}
+
+TEST(performance, mul) {
+  // the bound 2^1.2 * 1.5 ~ 3.45 per doubling rejects schoolbook (4x) but admits Karatsuba (~3x)
+  expect_growth(100000 / performance_scale, 1.2, [](size_t n) {
+    big_integer a(random_digits(n));
+    big_integer b(random_digits(n + 1));
+    return [a, b] { EXPECT_NE(0, a * b); };
+  });
+}
+
+TEST(performance, div) {
+  expect_growth(10000 / performance_scale, 2, [](size_t n) {
+    big_integer a(random_digits(2 * n));
+    big_integer b(random_digits(n + 1));
+    return [a, b] { EXPECT_NE(0, a / b); };
+  });
+}
+
+TEST(performance, add_sub) {
+  expect_growth(linear_limbs / performance_scale, 1, [](size_t n) {
+    big_integer a = random_limbs(n);
+    big_integer b = random_limbs(n + 1);
+    return [a, b] {
+      big_integer c = a + b;
+      c -= a;
+      EXPECT_EQ(c, b);
+    };
+  });
+}
+
+TEST(performance, shifts) {
+  expect_growth(linear_limbs / performance_scale, 1, [](size_t n) {
+    big_integer a = random_limbs(n);
+    return [a] { EXPECT_EQ(a, (a << 100003) >> 100003); };
+  });
+}
+
+TEST(performance, bitwise) {
+  expect_growth(linear_limbs / performance_scale, 1, [](size_t n) {
+    big_integer a = random_limbs(n);
+    big_integer b = random_limbs(n + 1);
+    return [a, b] {
+      EXPECT_EQ(a + b, (a & b) + (a | b));
+      EXPECT_EQ(a ^ b, (a | b) - (a & b));
+    };
+  });
+}
+
+TEST(stats, snapshot_and_reset) {
+  big_integer a = random_limbs(100);
+  big_integer_stats::reset();
+
+  big_integer b = a;
+  b -= 1;
+  big_integer c = a % 7;
+
+  big_integer_stats stats = big_integer_stats::snapshot();
+  if (!big_integer_stats::enabled()) {
+    EXPECT_EQ(0u, stats.calls[big_integer_stats::SUB]);
+    EXPECT_EQ(0u, stats.counters[big_integer_stats::ALLOCATIONS]);
+    return;
+  }
+  EXPECT_GE(stats.counters[big_integer_stats::SHARED_COPIES], 1u);
+  EXPECT_GE(stats.counters[big_integer_stats::UNSHARES], 1u);
+  EXPECT_GE(stats.counters[big_integer_stats::ALLOCATIONS], 1u);
+  EXPECT_EQ(1u, stats.calls[big_integer_stats::SUB]);
+  EXPECT_EQ(1u, stats.sizes[big_integer_stats::SUB][big_integer_stats::bucket(100)]);
+  EXPECT_EQ(1u, stats.calls[big_integer_stats::MOD]);
+  EXPECT_EQ(0u, stats.calls[big_integer_stats::DIV]);
+  EXPECT_EQ(0u, stats.calls[big_integer_stats::MUL]);
+
+  big_integer_stats::reset();
+  stats = big_integer_stats::snapshot();
+  EXPECT_EQ(0u, stats.calls[big_integer_stats::SUB]);
+  EXPECT_EQ(0u, stats.counters[big_integer_stats::SHARED_COPIES]);
+}
+
+TEST(parallel, thread_pool) {
+  thread_pool pool(4);
+  std::atomic<size_t> count(0);
+  {
+    thread_pool::task_group outer(&pool);
+    for (size_t i = 0; i != 16; ++i)
+      outer.spawn([&] {
+        thread_pool::task_group inner(&pool);
+        for (size_t j = 0; j != 16; ++j)
+          inner.spawn([&] { ++count; });
+        inner.wait();
+      });
+    outer.wait();
+  }
+  EXPECT_EQ(256u, count.load());
+
+  std::vector<size_t> marks(100000, 0);
+  parallel_for(&pool, 0, marks.size(), 1000, [&](size_t from, size_t to) {
+    for (size_t i = from; i != to; ++i)
+      ++marks[i];
+  });
+  EXPECT_EQ(marks.size(), static_cast<size_t>(std::count(marks.begin(), marks.end(), 1u)));
+
+  thread_pool::task_group failing(&pool);
+  failing.spawn([] { throw std::runtime_error("task failed"); });
+  EXPECT_THROW(failing.wait(), std::runtime_error);
+}
+
+TEST(parallel, mul_matches_serial) {
+  std::vector<std::pair<big_integer, big_integer>> operands;
+  operands.emplace_back(random_limbs(1000), random_limbs(900));
+  operands.emplace_back(random_limbs(20000), random_limbs(19000));
+  operands.emplace_back(random_limbs(20000), random_limbs(300));
+  operands.emplace_back(random_limbs(3000), random_limbs(3000) + 1);
+
+  std::vector<big_integer> serial;
+  for (auto const& ab : operands) {
+    serial.push_back(ab.first * ab.second);
+    serial.push_back(ab.first * ab.first);
+  }
+
+  size_t cutoff = thread_pool::parallel_cutoff();
+  thread_pool::set_parallel_cutoff(64);
+  for (size_t threads : {2, 3, 8}) {
+    thread_pool::set_threads(threads);
+    EXPECT_EQ(threads, thread_pool::threads());
+    for (size_t i = 0; i != operands.size(); ++i) {
+      EXPECT_EQ(serial[2 * i], operands[i].first * operands[i].second);
+      EXPECT_EQ(serial[2 * i + 1], operands[i].first * operands[i].first);
+    }
+  }
+  thread_pool::set_threads(1);
+  thread_pool::set_parallel_cutoff(cutoff);
+  EXPECT_EQ(1u, thread_pool::threads());
+}
+
+TEST(parallel, decimal_matches_serial) {
+  std::vector<std::string> digits;
+  for (size_t n : {600, 5000, 40000, 150000})
+    digits.push_back(random_digits(n));
+
+  size_t cutoff = thread_pool::parallel_cutoff();
+  thread_pool::set_parallel_cutoff(16);
+  thread_pool::set_threads(4);
+  for (std::string const& s : digits) {
+    big_integer a(s);
+    EXPECT_EQ(s, to_string(a));
+    EXPECT_EQ("-" + s, to_string(-a));
+  }
+  thread_pool::set_threads(1);
+  thread_pool::set_parallel_cutoff(cutoff);
+  for (std::string const& s : digits)
+    EXPECT_EQ(s, to_string(big_integer(s)));
+}
+
+TEST(parallel, decimal_powers_on_the_pool) {
+  // longer than any earlier conversion, so the powers and their divisors are built inside pool tasks
+  std::string s = random_digits(600000);
+  size_t cutoff = thread_pool::parallel_cutoff();
+  thread_pool::set_parallel_cutoff(16);
+  thread_pool::set_threads(4);
+  big_integer a(s);
+  EXPECT_EQ(s, to_string(a));
+  thread_pool::set_threads(1);
+  thread_pool::set_parallel_cutoff(cutoff);
+}
+
+TEST(montgomery, matches_gmp) {
+  std::default_random_engine rng(31);
+  for (size_t bits : {5, 32, 64, 100, 1000, 5000, 12250, 12320, 20000}) {
+    big_integer_gmp gm, ga, gb;
+    gm.random(bits, rng);
+    if (gm < 0)
+      gm = -gm;
+    gm = gm * 2 + 1;
+    ga.random(bits + 40, rng);
+    gb.random(bits / 2, rng);
+    big_integer m(to_string(gm)), a(to_string(ga)), b(to_string(gb));
+    big_integer_gmp gar = ga % gm, gbr = gb % gm;
+    if (gar < 0)
+      gar += gm;
+    if (gbr < 0)
+      gbr += gm;
+
+    montgomery_context ctx(m);
+    big_integer x = ctx.to_montgomery(a);
+    big_integer y = ctx.to_montgomery(b);
+    EXPECT_EQ(to_string(gar), to_string(ctx.from_montgomery(x)));
+    EXPECT_EQ(to_string(gar * gbr % gm), to_string(ctx.from_montgomery(ctx.mul(x, y))));
+    EXPECT_EQ(to_string(gar * gar % gm), to_string(ctx.from_montgomery(ctx.sqr(x))));
+    EXPECT_EQ(to_string((gar + gbr) % gm), to_string(ctx.from_montgomery(ctx.add(x, y))));
+    EXPECT_EQ(to_string((gar - gbr + gm) % gm), to_string(ctx.from_montgomery(ctx.sub(x, y))));
+    EXPECT_EQ(to_string((gm - gar) % gm), to_string(ctx.from_montgomery(ctx.sub(0, x))));
+
+    // a chain of in-place products sharing one scratch, the way an exponentiation runs
+    montgomery_context::scratch scratch;
+    big_integer acc = ctx.one();
+    big_integer_gmp expected = 1;
+    for (int i = 0; i != 20; ++i) {
+      ctx.mul(acc, acc, x, scratch);
+      ctx.sqr(acc, acc, scratch);
+      expected = expected * gar % gm;
+      expected = expected * expected % gm;
+    }
+    EXPECT_EQ(to_string(expected), to_string(ctx.from_montgomery(acc)));
+  }
+}
+
+TEST(montgomery, corner_cases) {
+  EXPECT_THROW(montgomery_context(big_integer(10)), std::invalid_argument);
+  EXPECT_THROW(montgomery_context(big_integer(0)), std::invalid_argument);
+  EXPECT_THROW(montgomery_context(big_integer(-7)), std::invalid_argument);
+
+  montgomery_context unit(1);
+  EXPECT_EQ(0, unit.one());
+  EXPECT_EQ(0, unit.from_montgomery(unit.mul(unit.to_montgomery(5), unit.to_montgomery(7))));
+
+  big_integer m = (big_integer(1) << 127) - 1;
+  montgomery_context ctx(m);
+  EXPECT_EQ(m - 1, ctx.from_montgomery(ctx.to_montgomery(-1)));
+  EXPECT_EQ(1, ctx.from_montgomery(ctx.mul(ctx.to_montgomery(-1), ctx.to_montgomery(-1))));
+  big_integer wide = m << 64;
+  EXPECT_THROW(ctx.mul(wide, big_integer(3)), std::invalid_argument);
+  EXPECT_THROW(ctx.sqr(wide), std::invalid_argument);
+  EXPECT_THROW(ctx.add(big_integer(3), wide), std::invalid_argument);
+  EXPECT_THROW(ctx.sub(wide, big_integer(3)), std::invalid_argument);
+  EXPECT_THROW(ctx.from_montgomery(wide), std::invalid_argument);
+  EXPECT_THROW(ctx.from_montgomery(m << (32 * 6 * static_cast<int>(ctx.size()))), std::invalid_argument);
+  EXPECT_EQ(0, ctx.from_montgomery(ctx.add(ctx.to_montgomery(-1), ctx.one())));
+  EXPECT_EQ(5, ctx.from_montgomery(ctx.to_montgomery(m * 3 + 5)));
+}
+
+TEST(barrett, matches_gmp) {
+  std::default_random_engine rng(32);
+  for (size_t bits : {3, 32, 33, 500, 1024, 1100, 3000, 9000, 40000}) {
+    big_integer_gmp gm;
+    gm.random(bits, rng);
+    if (gm < 0)
+      gm = -gm;
+    gm += 2;
+    big_integer m(to_string(gm));
+    barrett_context ctx(m);
+    for (size_t value_bits : {bits / 2, bits, 2 * bits - 1, 2 * bits + 40, 5 * bits}) {
+      big_integer_gmp gx;
+      gx.random(value_bits, rng);
+      big_integer x(to_string(gx));
+      big_integer_gmp gr = gx % gm;
+      if (gr < 0)
+        gr += gm;
+      EXPECT_EQ(to_string(gr), to_string(ctx.reduce(x)));
+    }
+    big_integer top = (m << static_cast<int>(32 * ctx.size())) - 1;
+    big_integer q, r;
+    ctx.divmod(top, q, r);
+    EXPECT_EQ(m - 1, r);
+    EXPECT_EQ((big_integer(1) << static_cast<int>(32 * ctx.size())) - 1, q);
+    ctx.divmod(m * 12345, q, r);
+    EXPECT_EQ(0, r);
+    EXPECT_EQ(12345, q);
+    ctx.divmod(m * 12345 - 1, q, q);
+    EXPECT_EQ(m - 1, q);
+    big_integer x = m * 12345 - 1;
+    ctx.divmod(x, q, x);
+    EXPECT_EQ(m - 1, x);
+    EXPECT_EQ(12344, q);
+  }
+}
+
+TEST(barrett, corner_cases) {
+  EXPECT_THROW(barrett_context(big_integer(0)), std::invalid_argument);
+  EXPECT_THROW(barrett_context(big_integer(-3)), std::invalid_argument);
+  barrett_context one(1);
+  EXPECT_EQ(0, one.reduce(big_integer("123456789012345678901234567890")));
+  barrett_context even(big_integer(1) << 100);
+  EXPECT_EQ(5, even.reduce((big_integer(7) << 300) + 5));
+  EXPECT_EQ((big_integer(1) << 100) - 5, even.reduce(-5));
+  EXPECT_EQ(0, even.reduce(-(big_integer(1) << 200)));
+}
+
+TEST(performance, barrett_beats_mod) {
+  big_integer m = random_limbs(1000);
+  std::vector<big_integer> values;
+  for (size_t i = 0; i != 20; ++i)
+    values.push_back(random_limbs(2000 - i) + static_cast<int>(i));
+  barrett_context ctx(m);
+  double barrett = best_time([&] {
+    for (big_integer const& x : values)
+      EXPECT_LT(ctx.reduce(x), m);
+  });
+  double mod = best_time([&] {
+    for (big_integer x : values) {
+      x %= m;
+      EXPECT_LT(x, m);
+    }
+  });
+  EXPECT_LT(barrett, mod);
+}
+
+TEST(pow_mod, matches_gmp) {
+  std::default_random_engine rng(33);
+  for (size_t bits : {20, 64, 200, 1024, 2048}) {
+    for (int parity = 0; parity != 2; ++parity) {
+      big_integer_gmp gb, ge, gm;
+      gb.random(bits + 30, rng);
+      ge.random(bits, rng);
+      gm.random(bits, rng);
+      if (ge < 0)
+        ge = -ge;
+      if (gm < 0)
+        gm = -gm;
+      gm = gm * 2 + 2 + parity;
+      big_integer b(to_string(gb)), e(to_string(ge)), m(to_string(gm));
+      EXPECT_EQ(to_string(pow_mod(gb, ge, gm)), to_string(pow_mod(b, e, m)));
+    }
+  }
+}
+
+TEST(pow_mod, corner_cases) {
+  EXPECT_EQ(1, pow_mod(big_integer(12345), 0, 7));
+  EXPECT_EQ(0, pow_mod(big_integer(12345), 0, 1));
+  EXPECT_EQ(0, pow_mod(big_integer(0), 5, 7));
+  EXPECT_EQ(6, pow_mod(big_integer(-1), 1, 7));
+  EXPECT_EQ(1, pow_mod(big_integer(-1), 2, 8));
+  EXPECT_EQ(3, pow_mod(big_integer(3), 1, 1024));
+  EXPECT_EQ(0, pow_mod(big_integer(2), 10, 1024));
+  // 2^89 = 1 modulo the Mersenne prime, 2^100 = 2 (mod 89)
+  EXPECT_EQ(big_integer(1) << 2, pow_mod(big_integer(2), big_integer(1) << 100, (big_integer(1) << 89) - 1));
+  big_integer p = (big_integer(1) << 127) - 1;
+  EXPECT_EQ(1, pow_mod(big_integer(3), p - 1, p));
+  EXPECT_EQ(3, pow_mod(big_integer(3), p, p));
+  EXPECT_THROW(pow_mod(big_integer(2), 3, 0), std::invalid_argument);
+  EXPECT_THROW(pow_mod(big_integer(2), 3, -5), std::invalid_argument);
+  EXPECT_THROW(pow_mod(big_integer(2), -3, 5), std::invalid_argument);
+}
+
+TEST(pow, matches_repeated_multiplication) {
+  std::default_random_engine rng(34);
+  for (size_t bits : {2, 31, 33, 100, 1000}) {
+    big_integer_gmp gb;
+    gb.random(bits, rng);
+    big_integer b(to_string(gb));
+    big_integer_gmp expected = 1;
+    for (uint64_t e = 0; e != 40; ++e) {
+      EXPECT_EQ(to_string(expected), to_string(pow(b, e)));
+      expected *= gb;
+    }
+  }
+  for (int small : {3, 7, 10, 12, -3, -6, 65535, 65536, 2147483647}) {
+    big_integer_gmp expected = 1;
+    for (uint64_t e = 0; e != 70; ++e) {
+      EXPECT_EQ(to_string(expected), to_string(pow(big_integer(small), e)));
+      expected *= small;
+    }
+  }
+}
+
+TEST(pow, special_bases) {
+  EXPECT_EQ(1, pow(big_integer(0), 0));
+  EXPECT_EQ(0, pow(big_integer(0), 5));
+  EXPECT_EQ(1, pow(big_integer(1), 1000000000000ull));
+  EXPECT_EQ(1, pow(big_integer(-1), 1000000000000ull));
+  EXPECT_EQ(-1, pow(big_integer(-1), 1000000000001ull));
+  EXPECT_EQ(big_integer(1) << 100000, pow(big_integer(2), 100000));
+  EXPECT_EQ(-(big_integer(1) << 99999), pow(big_integer(-2), 99999));
+  EXPECT_EQ(big_integer(1) << 640, pow(big_integer(1) << 64, 10));
+  EXPECT_EQ("1" + std::string(5000, '0'), to_string(pow(big_integer(10), 5000)));
+  EXPECT_EQ(pow(big_integer(3), 1000) * pow(big_integer(3), 2345), pow(big_integer(3), 3345));
+  EXPECT_THROW(pow(big_integer(2), uint64_t(1) << 40), std::length_error);
+}
+
+TEST(performance, pow) {
+  expect_growth(200000 / performance_scale, 1.6, [](size_t n) {
+    return [n] { EXPECT_NE(0, pow(big_integer(3), n)); };
+  });
+}
+
+TEST(gcd, matches_gmp_euclid) {
+  std::default_random_engine rng(35);
+  for (size_t bits : {10, 60, 64, 65, 200, 1000, 5000, 20000, 60000}) {
+    big_integer_gmp gg, ga, gb;
+    gg.random(bits / 3, rng);
+    ga.random(bits, rng);
+    gb.random(bits - bits / 7, rng);
+    ga *= gg;
+    gb *= gg;
+    big_integer_gmp x = ga < 0 ? -ga : ga, y = gb < 0 ? -gb : gb;
+    while (y != 0) {
+      big_integer_gmp r = x % y;
+      x = y;
+      y = r;
+    }
+    big_integer a(to_string(ga)), b(to_string(gb));
+    big_integer g = gcd(a, b);
+    EXPECT_EQ(to_string(x), to_string(g));
+    EXPECT_EQ(g, gcd(b, a));
+
+    big_integer s, t;
+    EXPECT_EQ(g, ext_gcd(a, b, s, t));
+    EXPECT_EQ(g, a * s + b * t);
+    EXPECT_EQ(a / g * b, lcm(a, b) * ((a < 0) != (b < 0) ? -1 : 1));
+  }
+}
+
+TEST(gcd, fibonacci_worst_case) {
+  big_integer f0 = 0, f1 = 1;
+  for (int i = 0; i != 20000; ++i) {
+    f0 += f1;
+    std::swap(f0, f1);
+  }
+  EXPECT_EQ(1, gcd(f0, f1));
+  big_integer s, t;
+  EXPECT_EQ(1, ext_gcd(f1, f0, s, t));
+  EXPECT_EQ(1, f1 * s + f0 * t);
+}
+
+TEST(gcd, corner_cases) {
+  EXPECT_EQ(0, gcd(0, 0));
+  EXPECT_EQ(5, gcd(-5, 0));
+  EXPECT_EQ(5, gcd(0, 5));
+  EXPECT_EQ(6, gcd(-12, 18));
+  EXPECT_EQ(36, lcm(-12, 18));
+  EXPECT_EQ(0, lcm(0, 18));
+  EXPECT_EQ(big_integer(1) << 200, gcd(big_integer(3) << 200, big_integer(5) << 300));
+
+  big_integer s, t;
+  EXPECT_EQ(7, ext_gcd(0, -7, s, t));
+  EXPECT_EQ(7, -7 * t);
+  EXPECT_EQ(3, ext_gcd(-21, 6, s, t));
+  EXPECT_EQ(3, -21 * s + 6 * t);
+
+  EXPECT_EQ(4, mod_inverse(3, 11));
+  EXPECT_EQ(7, mod_inverse(-3, 11));
+  EXPECT_EQ(0, mod_inverse(5, 1));
+  big_integer p = (big_integer(1) << 521) - 1;
+  big_integer a = pow(big_integer(3), 300);
+  EXPECT_EQ(1, a * mod_inverse(a, p) % p);
+  EXPECT_THROW(mod_inverse(6, 9), std::domain_error);
+  EXPECT_THROW(mod_inverse(2, 0), std::invalid_argument);
+
+  EXPECT_EQ(0u, bit_length(0));
+  EXPECT_EQ(1u, bit_length(-1));
+  EXPECT_EQ(101u, bit_length(big_integer(1) << 100));
+}
+
+TEST(performance, gcd) {
+  expect_growth(2000 / performance_scale, 2, [](size_t n) {
+    big_integer a = random_limbs(n), b = random_limbs(n - 1) * 3 + 1;
+    return [a, b] { EXPECT_NE(0, gcd(a, b)); };
+  });
+}
+
+TEST(roots, bracket_the_operand) {
+  std::default_random_engine rng(36);
+  for (size_t limbs : {1, 2, 3, 5, 40, 300, 1200}) {
+    big_integer a = random_limbs(limbs);
+    for (unsigned k : {2u, 3u, 5u, 7u, 64u, 100u}) {
+      big_integer r = iroot(a, k);
+      EXPECT_LE(pow(r, k), a);
+      EXPECT_GT(pow(r + 1, k), a);
+    }
+    big_integer s = isqrt(a);
+    EXPECT_LE(s * s, a);
+    EXPECT_GT((s + 1) * (s + 1), a);
+    EXPECT_EQ(s, isqrt(s * s));
+    EXPECT_EQ(s - 1, isqrt(s * s - 1));
+    EXPECT_EQ(-iroot(a, 3), iroot(-a, 3));
+  }
+}
+
+TEST(roots, corner_cases) {
+  EXPECT_EQ(0, isqrt(0));
+  EXPECT_EQ(1, isqrt(3));
+  EXPECT_EQ(2, isqrt(4));
+  EXPECT_EQ(4294967295u, isqrt((big_integer(1) << 64) - 1));
+  EXPECT_EQ(big_integer(1) << 32, isqrt(big_integer(1) << 64));
+  EXPECT_EQ(1, iroot(big_integer(1) << 100, 101));
+  EXPECT_EQ(2, iroot(big_integer(1) << 100, 100));
+  EXPECT_EQ(-2, iroot(-9, 3));
+  EXPECT_EQ(12345, iroot(12345, 1));
+  EXPECT_THROW(isqrt(-1), std::domain_error);
+  EXPECT_THROW(iroot(5, 0), std::invalid_argument);
+}
+
+TEST(roots, perfect_powers) {
+  std::default_random_engine rng(360);
+  big_integer base;
+  uint64_t exp;
+  for (size_t limbs : {1, 2, 7, 100}) {
+    big_integer b = random_limbs(limbs);
+    if (perfect_power(b)) {
+      continue;
+    }
+    for (uint64_t k : {2, 3, 6, 15}) {
+      big_integer a = pow(b, k);
+      EXPECT_TRUE(perfect_power(a, base, exp));
+      EXPECT_EQ(b, base);
+      EXPECT_EQ(k, exp);
+      EXPECT_EQ(k % 2 == 0, is_square(a));
+      EXPECT_FALSE(perfect_power(a + 1));
+      EXPECT_FALSE(is_square(a + 1));
+      EXPECT_EQ(k != 2, perfect_power(-a, base, exp));
+      if (k == 6) {
+        EXPECT_EQ(-b * b, base);
+        EXPECT_EQ(3u, exp);
+      }
+    }
+  }
+  EXPECT_TRUE(perfect_power(big_integer(1) << 60, base, exp));
+  EXPECT_EQ(2, base);
+  EXPECT_EQ(60u, exp);
+  EXPECT_TRUE(perfect_power(-1, base, exp));
+  EXPECT_TRUE(perfect_power(0));
+  EXPECT_TRUE(is_square(0));
+  EXPECT_FALSE(is_square(-4));
+  EXPECT_FALSE(perfect_power(2));
+  EXPECT_FALSE(perfect_power(-4));
+  EXPECT_FALSE(perfect_power(big_integer(12) << 200));
+  EXPECT_FALSE(is_square(pow(big_integer(3), 41)));
+}
+
+TEST(performance, isqrt) {
+  expect_growth(20000 / performance_scale, 1.6, [](size_t n) {
+    big_integer a = random_limbs(n);
+    return [a] { EXPECT_NE(0, isqrt(a)); };
+  });
+}
+
+TEST(primes, matches_sieve) {
+  size_t const n = 200000;
+  std::vector<bool> composite(n, false);
+  composite[0] = composite[1] = true;
+  for (size_t i = 2; i * i < n; ++i) {
+    for (size_t j = i * i; !composite[i] && j < n; j += i) {
+      composite[j] = true;
+    }
+  }
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(!composite[i], is_probable_prime(big_integer(static_cast<uint32_t>(i)))) << i;
+  }
+  EXPECT_FALSE(is_probable_prime(-7));
+}
+
+TEST(primes, pseudoprimes) {
+  // strong pseudoprimes to base 2, strong Lucas pseudoprimes and Carmichael numbers
+  for (uint32_t c : {2047u, 3277u, 4033u, 4681u, 8321u, 3215031751u, 5459u, 5777u, 10877u,
+                     16109u, 18971u, 561u, 1105u, 41041u, 825265u}) {
+    EXPECT_FALSE(is_probable_prime(big_integer(c))) << c;
+  }
+  big_integer m521 = (big_integer(1) << 521) - 1, m607 = (big_integer(1) << 607) - 1;
+  EXPECT_TRUE(is_probable_prime(m521));
+  EXPECT_TRUE(is_probable_prime(m607));
+  EXPECT_FALSE(is_probable_prime((big_integer(1) << 523) - 1));
+  EXPECT_FALSE(is_probable_prime(m521 * m607));
+  EXPECT_FALSE(is_probable_prime(m521 * m521));
+  EXPECT_FALSE(is_probable_prime(m521 * 2039));
+}
+
+TEST(primes, matches_gmp) {
+  std::default_random_engine rng(37);
+  std::vector<big_integer> candidates;
+  std::vector<bool> expected;
+  for (size_t bits : {64, 100, 512, 1024, 2048}) {
+    for (int i = 0; i < 40; ++i) {
+      big_integer_gmp g;
+      g.random(bits, rng);
+      if (g < 0) {
+        g = -g;
+      }
+      g = g * 2 + 1;
+      candidates.push_back(big_integer(to_string(g)));
+      expected.push_back(is_probable_prime(g));
+      EXPECT_EQ(expected.back(), is_probable_prime(candidates.back())) << to_string(g);
+    }
+  }
+  thread_pool::set_threads(4);
+  EXPECT_EQ(expected, is_probable_prime(candidates));
+  thread_pool::set_threads(1);
+  EXPECT_EQ(expected, is_probable_prime(candidates));
+}
+
+TEST(primes, shared_candidates) {
+  // the copies share one buffer, the workers copy and drop it side by side
+  std::vector<big_integer> candidates(64, (big_integer(1) << 607) - 1);
+  thread_pool::set_threads(4);
+  EXPECT_EQ(std::vector<bool>(64, true), is_probable_prime(candidates));
+  thread_pool::set_threads(1);
+  EXPECT_EQ((big_integer(1) << 607) - 1, candidates[63]);
+}
+
+TEST(combinatorics, small_values) {
+  big_integer f = 1;
+  for (uint32_t n = 0; n <= 300; ++n) {
+    if (n != 0) {
+      f *= n;
+    }
+    EXPECT_EQ(f, factorial(n)) << n;
+  }
+  std::vector<big_integer> row = {1};
+  for (uint32_t n = 0; n <= 150; ++n) {
+    for (uint32_t k = 0; k <= n; ++k) {
+      EXPECT_EQ(row[k], binomial(n, k)) << n << ' ' << k;
+    }
+    EXPECT_EQ(0, binomial(n, n + 1));
+    std::vector<big_integer> next(n + 2, 1);
+    for (uint32_t k = 1; k <= n; ++k) {
+      next[k] = row[k - 1] + row[k];
+    }
+    row = next;
+  }
+  EXPECT_EQ(1, primorial(0));
+  EXPECT_EQ(1, primorial(1));
+  EXPECT_EQ(2, primorial(2));
+  EXPECT_EQ(30, primorial(6));
+  EXPECT_EQ(big_integer("614889782588491410"), primorial(50));
+}
+
+TEST(combinatorics, large_identities) {
+  for (uint32_t n : {5000u, 30000u}) {
+    big_integer f = factorial(n);
+    EXPECT_EQ(f, factorial(n - 1) * n);
+    for (uint32_t k : {1u, 7u, n / 100, n / 3}) {
+      EXPECT_EQ(f, binomial(n, k) * factorial(k) * factorial(n - k)) << n << ' ' << k;
+    }
+  }
+  EXPECT_EQ(binomial(1000000000u, 3), big_integer("166666666166666667000000000"));
+  thread_pool::set_threads(4);
+  EXPECT_EQ(factorial(100000), factorial(99999) * 100000);
+  EXPECT_EQ(primorial(200000), primorial(199999));
+  thread_pool::set_threads(1);
+}
+
+TEST(performance, factorial) {
+  expect_growth(200000 / performance_scale, 1.6, [](size_t n) {
+    return [n] { EXPECT_NE(0, factorial(static_cast<uint32_t>(n))); };
+  });
+}
+
+TEST(fibonacci, matches_recurrence) {
+  big_integer f0 = 0, f1 = 1, l0 = 2, l1 = 1;
+  for (uint64_t n = 0; n != 3000; ++n) {
+    EXPECT_EQ(f0, fibonacci(n)) << n;
+    EXPECT_EQ(l0, lucas(n)) << n;
+    f0 += f1;
+    std::swap(f0, f1);
+    l0 += l1;
+    std::swap(l0, l1);
+  }
+}
+
+TEST(fibonacci, large_identities) {
+  for (uint64_t n : {100000u, 1234567u}) {
+    big_integer f = fibonacci(n), l = lucas(n);
+    EXPECT_EQ(fibonacci(2 * n), f * l);
+    EXPECT_EQ(fibonacci(n + 1), fibonacci(n - 1) + f);
+    // L_n^2 - 5 F_n^2 = 4 (-1)^n
+    EXPECT_EQ(n % 2 == 0 ? 4 : -4, l * l - 5 * f * f);
+  }
+}
+
+TEST(performance, fibonacci) {
+  expect_growth(2000000 / performance_scale, 1.6, [](size_t n) {
+    return [n] { EXPECT_NE(0, fibonacci(n)); };
+  });
+}
+
+TEST(remainders, matches_mod) {
+  std::default_random_engine rng(40);
+  std::uniform_int_distribution<uint32_t> limb;
+  for (size_t limbs : {1, 3, 50, 3000}) {
+    big_integer x = random_limbs(limbs);
+    std::vector<big_integer> moduli;
+    for (size_t i = 0; i != 300; ++i) {
+      if (i % 50 == 7) {
+        moduli.push_back(random_limbs(1 + i / 10) + 1);
+      } else {
+        moduli.push_back(big_integer(limb(rng) | 1u));
+      }
+    }
+    moduli.push_back(1);
+    moduli.push_back(big_integer(UINT32_MAX));
+    for (big_integer const& y : {x, -x}) {
+      std::vector<big_integer> r = remainders(y, moduli);
+      ASSERT_EQ(moduli.size(), r.size());
+      for (size_t i = 0; i != moduli.size(); ++i) {
+        big_integer expected = y % moduli[i];
+        EXPECT_EQ(expected < 0 ? expected + moduli[i] : expected, r[i]) << i;
+      }
+    }
+  }
+  EXPECT_TRUE(remainders(5, {}).empty());
+  EXPECT_THROW(remainders(5, {3, 0}), std::invalid_argument);
+  EXPECT_THROW(remainders(5, {-3}), std::invalid_argument);
+}
+
+TEST(remainders, parallel_matches_serial) {
+  big_integer x = random_limbs(20000);
+  std::vector<big_integer> moduli;
+  for (size_t i = 0; i != 2000; ++i)
+    moduli.push_back(random_limbs(1 + i % 7) + 1);
+  std::vector<big_integer> serial = remainders(x, moduli);
+  thread_pool::set_threads(4);
+  EXPECT_EQ(serial, remainders(x, moduli));
+  thread_pool::set_threads(1);
+}
+
+TEST(remainders, shared_moduli) {
+  // the leaves and tree nodes share one buffer, copied and dropped by the workers
+  big_integer m = (big_integer(1) << 4000) - 1;
+  big_integer x = random_limbs(20000);
+  std::vector<big_integer> moduli(64, m);
+  thread_pool::set_threads(4);
+  EXPECT_EQ(std::vector<big_integer>(64, x % m), remainders(x, moduli));
+  thread_pool::set_threads(1);
+}
+
+TEST(performance, remainders_beat_mod) {
+  big_integer x = random_limbs(10000);
+  std::vector<big_integer> moduli;
+  for (size_t i = 0; i != 2000; ++i)
+    moduli.push_back(random_limbs(1 + i % 3) + 1);
+  double tree = best_time([&] { EXPECT_EQ(moduli.size(), remainders(x, moduli).size()); });
+  double mod = best_time([&] {
+    for (big_integer const& m : moduli)
+      EXPECT_LT(x % m, m);
+  });
+  EXPECT_LT(tree, mod);
+}
+
+TEST(rns, round_trip_and_arithmetic) {
+  for (size_t primes : {1, 2, 5, 64, 300}) {
+    auto basis = std::make_shared<rns_basis const>(primes);
+    size_t limbs = primes / 4;
+    big_integer x = limbs == 0 ? big_integer(12345) : random_limbs(limbs);
+    big_integer y = limbs == 0 ? big_integer(-678) : -random_limbs(limbs);
+    rns_integer rx(basis, x), ry(basis, y);
+    EXPECT_EQ(x, rx.to_big_integer());
+    EXPECT_EQ(y, ry.to_big_integer());
+    EXPECT_EQ(x + y, (rx + ry).to_big_integer());
+    EXPECT_EQ(x - y, (rx - ry).to_big_integer());
+    EXPECT_EQ(-x, (-rx).to_big_integer());
+    EXPECT_EQ(x * y, (rx * ry).to_big_integer());
+    for (size_t i = 0; i != basis->size(); ++i) {
+      big_integer expected = x % basis->prime(i);
+      EXPECT_EQ(expected, big_integer(rx.residue(i)));
+    }
+  }
+}
+
+TEST(rns, dot_product) {
+  auto basis = std::make_shared<rns_basis const>(200);
+  std::vector<big_integer> a, b;
+  for (size_t i = 0; i != 20; ++i) {
+    a.push_back(random_limbs(40) * (i % 2 == 0 ? 1 : -1));
+    b.push_back(random_limbs(40));
+  }
+  big_integer expected = 0;
+  rns_integer acc(basis, 0);
+  for (size_t i = 0; i != a.size(); ++i) {
+    expected += a[i] * b[i];
+    acc += rns_integer(basis, a[i]) * rns_integer(basis, b[i]);
+  }
+  EXPECT_EQ(expected, acc.to_big_integer());
+  EXPECT_EQ(basis->modulus() / 2, rns_integer(basis, basis->modulus() / 2).to_big_integer());
+  EXPECT_EQ(1, rns_integer(basis, basis->modulus() + 1).to_big_integer());
+  EXPECT_THROW(acc += rns_integer(std::make_shared<rns_basis const>(200), 1), std::invalid_argument);
+  EXPECT_THROW(rns_basis(0), std::invalid_argument);
+}
+
+TEST(expr, matches_plain_arithmetic) {
+  for (size_t limbs : {1, 2, 30, 400}) {
+    big_integer a = random_limbs(limbs), b = -random_limbs(limbs / 2 + 1), c = random_limbs(limbs + 3);
+    big_integer d = random_limbs(limbs) - 7, e = -random_limbs(limbs * 2), m = random_limbs(limbs) + 1;
+    big_integer r;
+    r = lazy(a) * b + lazy(c) * d - e;
+    EXPECT_EQ(a * b + c * d - e, r);
+    r = lazy(a) * b + c;
+    EXPECT_EQ(a * b + c, r);
+    r = c - lazy(a) * b;
+    EXPECT_EQ(c - a * b, r);
+    r = lazy(a) * b - c;
+    EXPECT_EQ(a * b - c, r);
+    r = lazy(a) * b % m;
+    EXPECT_EQ(a * b % m, r);
+    r = lazy(e) * a % m;
+    EXPECT_EQ(e * a % m, r);
+    r = lazy(a) * b % e;
+    EXPECT_EQ(a * b % e, r);
+    r = lazy(m) * b % m;
+    EXPECT_EQ(0, r);
+    r = (lazy(b) + 0) % c;
+    EXPECT_EQ(b, r);
+    r = (lazy(a) + b) * (lazy(c) - d) / m;
+    EXPECT_EQ((a + b) * (c - d) / m, r);
+    r = -(lazy(a) - a) + (lazy(e) - e);
+    EXPECT_EQ(0, r);
+    big_integer constructed = lazy(a) * a - lazy(b) * b;
+    EXPECT_EQ(a * a - b * b, constructed);
+    r = lazy(a) + 1;
+    EXPECT_EQ(a + 1, r);
+  }
+}
+
+TEST(expr, destination_in_the_tree) {
+  big_integer a = random_limbs(50), b = random_limbs(20), c = -random_limbs(70);
+  big_integer acc = c;
+  acc += lazy(a) * b;
+  EXPECT_EQ(c + a * b, acc);
+  acc -= lazy(a) * b;
+  EXPECT_EQ(c, acc);
+  acc -= lazy(acc) * a;
+  EXPECT_EQ(c - c * a, acc);
+  acc = lazy(a) * acc + acc;
+  EXPECT_EQ(a * (c - c * a) + (c - c * a), acc);
+  big_integer x = a;
+  x = lazy(x) * x - x;
+  EXPECT_EQ(a * a - a, x);
+  x = a;
+  x += lazy(x) + x;
+  EXPECT_EQ(3 * a, x);
+  x = a;
+  x = lazy(x) * x % b;
+  EXPECT_EQ(a * a % b, x);
+  EXPECT_THROW(x = lazy(a) * b % big_integer(0), std::runtime_error);
+}
+
+TEST(addmul, matches_plain_arithmetic) {
+  std::default_random_engine rng(43);
+  std::uniform_int_distribution<uint32_t> limb;
+  for (size_t xl : {1, 3, 40, 300}) {
+    for (size_t yl : {1, 2, 33, 200}) {
+      for (int signs = 0; signs != 8; ++signs) {
+        big_integer acc = random_limbs(xl + yl - (signs % 3)) * ((signs & 1) ? -1 : 1);
+        big_integer x = random_limbs(xl) * ((signs & 2) ? -1 : 1);
+        big_integer y = random_limbs(yl) * ((signs & 4) ? -1 : 1);
+        big_integer r = acc;
+        addmul(r, x, y);
+        EXPECT_EQ(acc + x * y, r);
+        r = acc;
+        submul(r, x, y);
+        EXPECT_EQ(acc - x * y, r);
+        uint32_t s = limb(rng);
+        r = acc;
+        addmul(r, x, s);
+        EXPECT_EQ(acc + x * s, r);
+        r = acc;
+        submul(r, x, s);
+        EXPECT_EQ(acc - x * s, r);
+        int t = static_cast<int>(s);
+        r = acc;
+        addmul(r, x, t);
+        EXPECT_EQ(acc + x * t, r);
+        r = acc;
+        submul(r, x, t);
+        EXPECT_EQ(acc - x * t, r);
+      }
+    }
+  }
+}
+
+TEST(addmul, corner_cases) {
+  big_integer a = random_limbs(10), b = random_limbs(5);
+  big_integer r = 0;
+  addmul(r, a, b);
+  EXPECT_EQ(a * b, r);
+  submul(r, a, b);
+  EXPECT_EQ(0, r);
+  submul(r, a, b);
+  EXPECT_EQ(-(a * b), r);
+  r = a * b;
+  submul(r, b, a);
+  EXPECT_EQ(0, r);
+  addmul(r, a, 0u);
+  addmul(r, 0, b);
+  EXPECT_EQ(0, r);
+  r = a;
+  addmul(r, r, r);
+  EXPECT_EQ(a + a * a, r);
+  r = a;
+  submul(r, r, 3u);
+  EXPECT_EQ(-2 * a, r);
+  big_integer shared = a;
+  r = a;
+  addmul(r, shared, b);
+  EXPECT_EQ(a + a * b, r);
+  EXPECT_EQ(a, shared);
+  r = 0;
+  addmul(r, a, -5);
+  EXPECT_EQ(-5 * a, r);
+  submul(r, a, -5);
+  EXPECT_EQ(0, r);
+  addmul(r, a, std::numeric_limits<int>::min());
+  EXPECT_EQ(a * std::numeric_limits<int>::min(), r);
+  addmul(r, r, -1);
+  EXPECT_EQ(0, r);
+}
+
+TEST(accumulator, matches_plain_arithmetic) {
+  big_integer_accumulator acc;
+  big_integer expected = 0;
+  EXPECT_EQ(0, acc.value());
+  for (size_t i = 0; i != 200; ++i) {
+    big_integer x = random_limbs(1 + i % 50) * (i % 3 == 0 ? -1 : 1);
+    big_integer y = random_limbs(1 + i % 70) + static_cast<int>(i);
+    switch (i % 4) {
+    case 0:
+      acc += x;
+      expected += x;
+      break;
+    case 1:
+      acc -= y;
+      expected -= y;
+      break;
+    case 2:
+      acc.addmul(x, y);
+      expected += x * y;
+      break;
+    default:
+      acc.submul(x, y);
+      expected -= x * y;
+    }
+    if (i % 37 == 0) {
+      EXPECT_EQ(expected, acc.value());
+    }
+  }
+  EXPECT_EQ(expected, acc.value());
+  acc.clear();
+  EXPECT_EQ(0, acc.value());
+  acc += expected;
+  acc -= expected;
+  EXPECT_EQ(0, acc.value());
+}
+
+TEST(accumulator, dot_product) {
+  std::vector<big_integer> a, b;
+  for (size_t i = 0; i != 100; ++i) {
+    a.push_back(random_limbs(20 + i % 30) * (i % 2 == 0 ? 1 : -1));
+    b.push_back(random_limbs(10 + i % 40));
+  }
+  big_integer expected = 0;
+  big_integer_accumulator acc;
+  for (size_t i = 0; i != a.size(); ++i) {
+    expected += a[i] * b[i];
+    acc.addmul(a[i], b[i]);
+  }
+  EXPECT_EQ(expected, acc.value());
+  big_integer max = (big_integer(1) << 3200) - 1;
+  big_integer_accumulator sum;
+  for (size_t i = 0; i != 1000; ++i)
+    sum.addmul(max, max);
+  EXPECT_EQ(1000 * max * max, sum.value());
+}
+
+TEST(performance, accumulator_beats_plus) {
+  std::vector<big_integer> a, b;
+  for (size_t i = 0; i != 2000; ++i) {
+    a.push_back(random_limbs(8 + i % 3));
+    b.push_back(random_limbs(8 + i % 5));
+  }
+  big_integer expected = 0;
+  double plain = best_time([&] {
+    expected = 0;
+    for (size_t i = 0; i != a.size(); ++i)
+      expected += a[i] * b[i];
+  });
+  double fused = best_time([&] {
+    big_integer_accumulator acc;
+    for (size_t i = 0; i != a.size(); ++i)
+      acc.addmul(a[i], b[i]);
+    EXPECT_EQ(expected, acc.value());
+  });
+  EXPECT_LT(fused, plain);
+}
+
+TEST(reduction, matches_serial_folds) {
+  std::vector<big_integer> terms;
+  big_integer sum = 0, product = 1;
+  for (size_t i = 0; i != 1000; ++i) {
+    terms.push_back(random_limbs(1 + i % 40 + (i % 97 == 0 ? 500 : 0)) * (i % 3 == 0 ? -1 : 1));
+    sum += terms.back();
+  }
+  std::vector<big_integer> factors(terms.begin(), terms.begin() + 300);
+  for (big_integer const& f : factors)
+    product *= f;
+  EXPECT_EQ(sum, parallel_sum(terms));
+  EXPECT_EQ(product, parallel_product(factors));
+  EXPECT_EQ(product, merge_all(factors));
+  thread_pool::set_threads(4);
+  EXPECT_EQ(sum, parallel_sum(terms));
+  EXPECT_EQ(product, parallel_product(factors));
+  thread_pool::set_threads(1);
+}
+
+TEST(reduction, corner_cases) {
+  EXPECT_EQ(0, parallel_sum({}));
+  EXPECT_EQ(1, parallel_product({}));
+  big_integer a = -random_limbs(30);
+  EXPECT_EQ(a, parallel_sum({a}));
+  EXPECT_EQ(a, parallel_product({a}));
+  EXPECT_EQ(0, parallel_sum({a, -a}));
+  EXPECT_EQ(0, parallel_product({a, 0, a}));
+  EXPECT_EQ(a * a, parallel_product({a, -1, -a, -1}) * -1);
+  // the factors share one buffer, the leaves are taken on several threads at once
+  big_integer m = (big_integer(1) << 4000) - 1;
+  thread_pool::set_threads(4);
+  EXPECT_EQ(pow(m, 64), parallel_product(std::vector<big_integer>(64, m)));
+  thread_pool::set_threads(1);
+}
+
+TEST(performance, parallel_product_beats_fold) {
+  std::vector<big_integer> factors;
+  for (size_t i = 0; i != 3000; ++i)
+    factors.push_back(random_limbs(10) + static_cast<int>(i));
+  big_integer expected = 1;
+  double fold = best_time([&] {
+    expected = 1;
+    for (big_integer const& f : factors)
+      expected *= f;
+  });
+  double tree = best_time([&] { EXPECT_EQ(expected, parallel_product(factors)); });
+  EXPECT_LT(tree, fold);
+}
+
+TEST(view, matches_big_integer) {
+  std::vector<big_integer> values = {0, 1, -1, 42, -42, random_limbs(3), -random_limbs(3), random_limbs(60),
+                                     -random_limbs(60), random_limbs(61), big_integer(1) << 96};
+  for (big_integer const& a : values) {
+    big_integer_view v = a;
+    EXPECT_EQ(to_string(a), to_string(v));
+    EXPECT_EQ(bit_length(a), bit_length(v));
+    EXPECT_EQ(a, big_integer(v));
+    std::stringstream out;
+    out << v;
+    EXPECT_EQ(to_string(a), out.str());
+    EXPECT_EQ(std::hash<big_integer>()(a), std::hash<big_integer_view>()(v));
+    for (big_integer const& b : values) {
+      big_integer_view w = b;
+      EXPECT_EQ(a == b, v == w);
+      EXPECT_EQ(a != b, v != w);
+      EXPECT_EQ(a < b, v < w);
+      EXPECT_EQ(a > b, v > w);
+      EXPECT_EQ(a <= b, v <= w);
+      EXPECT_EQ(a >= b, v >= w);
+      EXPECT_EQ(a < b, a < w);
+      EXPECT_EQ(a & b, v & w);
+      EXPECT_EQ(a | b, v | w);
+      EXPECT_EQ(a ^ b, v ^ w);
+    }
+    for (int shift : {0, 1, 31, 32, 77}) {
+      EXPECT_EQ(a << shift, v << shift);
+      EXPECT_EQ(a >> shift, v >> shift);
+      EXPECT_EQ(bits_at(a, shift), bits_at(v, shift));
+    }
+  }
+}
+
+TEST(view, external_limbs) {
+  uint32_t limbs[] = {5, 1, 0, 0};
+  big_integer_view v(-1, limbs, 4);
+  EXPECT_EQ(2u, v.size());
+  EXPECT_EQ(-((big_integer(1) << 32) + 5), big_integer(v));
+  EXPECT_EQ("-4294967301", to_string(v));
+  EXPECT_EQ(33u, bit_length(v));
+  big_integer_view zero(-1, limbs + 2, 2);
+  EXPECT_EQ(1, zero.sign());
+  EXPECT_EQ(0u, zero.size());
+  EXPECT_EQ("0", to_string(zero));
+  EXPECT_TRUE(zero == big_integer(0));
+  EXPECT_EQ(std::hash<big_integer>()(0), std::hash<big_integer_view>()(zero));
+  EXPECT_EQ(0, compare(big_integer_view(1, limbs, 1), big_integer(5)));
+  EXPECT_EQ(-1, compare(v, big_integer(-5)));
+  EXPECT_EQ(1, compare(big_integer(-5), v));
+  EXPECT_EQ(1, v & big_integer_view(1, limbs, 1));
+  EXPECT_EQ(-((big_integer(1) << 32) + 1), v | big_integer(4));
+  EXPECT_EQ(0, v ^ v);
+  EXPECT_EQ(-((big_integer(1) << 36) + 80), v << 4);
+  EXPECT_EQ((uint64_t(1) << 31) + 2, bits_at(v, 1));
+}
+
+TEST(bytes, matches_mpz_export) {
+  std::vector<big_integer> values = {0, 1, 255, 256, 65535, random_limbs(1), random_limbs(7), random_limbs(100),
+                                     (big_integer(1) << 77) + 3};
+  for (big_integer const& a : values) {
+    mpz_t z;
+    mpz_init_set_str(z, to_string(a).c_str(), 10);
+    for (int order : {-1, 1}) {
+      size_t count = 0;
+      uint8_t* exported = static_cast<uint8_t*>(mpz_export(nullptr, &count, order, 1, 0, 0, z));
+      std::vector<uint8_t> expected(exported, exported + count);
+      free(exported);
+      byte_order bo = order < 0 ? byte_order::little_endian : byte_order::big_endian;
+      EXPECT_EQ(expected, to_bytes(a, bo));
+      EXPECT_EQ(expected, to_bytes(-a, bo));
+      EXPECT_EQ(a, from_bytes(expected.data(), expected.size(), bo));
+      mpz_t back;
+      mpz_init(back);
+      mpz_import(back, count, order, 1, 0, 0, expected.data());
+      EXPECT_EQ(0, mpz_cmp(z, back));
+      mpz_clear(back);
+    }
+    mpz_clear(z);
+  }
+}
+
+TEST(bytes, twos_complement) {
+  EXPECT_EQ(std::vector<uint8_t>({0}), to_bytes(big_integer(0), byte_order::little_endian, byte_format::twos_complement));
+  EXPECT_EQ(std::vector<uint8_t>({0xff}), to_bytes(big_integer(-1), byte_order::little_endian, byte_format::twos_complement));
+  EXPECT_EQ(std::vector<uint8_t>({0x80}), to_bytes(big_integer(-128), byte_order::big_endian, byte_format::twos_complement));
+  EXPECT_EQ(std::vector<uint8_t>({0x00, 0x80}), to_bytes(big_integer(128), byte_order::big_endian, byte_format::twos_complement));
+  EXPECT_EQ(std::vector<uint8_t>({0x7f, 0xff}), to_bytes(big_integer(-129), byte_order::little_endian, byte_format::twos_complement));
+  big_integer min = -(big_integer(1) << 63);
+  EXPECT_EQ(8u, byte_length(min, byte_format::twos_complement));
+  EXPECT_EQ(9u, byte_length(min - 1, byte_format::twos_complement));
+  std::vector<big_integer> values = {min, min - 1, -min, random_limbs(9), -random_limbs(9), -random_limbs(4) * 256};
+  for (int i = 1; i < 300; i += 37)
+    values.push_back((big_integer(-1) << i) + i % 3);
+  for (big_integer const& a : values) {
+    for (byte_order order : {byte_order::little_endian, byte_order::big_endian}) {
+      std::vector<uint8_t> b = to_bytes(a, order, byte_format::twos_complement);
+      EXPECT_EQ(a, from_bytes(b.data(), b.size(), order, byte_format::twos_complement));
+      b.insert(order == byte_order::little_endian ? b.end() : b.begin(), 3, a < 0 ? 0xff : 0);
+      EXPECT_EQ(a, from_bytes(b.data(), b.size(), order, byte_format::twos_complement));
+    }
+  }
+  EXPECT_EQ(0, from_bytes(nullptr, 0));
+}
+
+TEST(bytes, serialization) {
+  std::vector<big_integer> values = {0, 1, -1, 127, -128, random_limbs(3), -random_limbs(50), random_limbs(200)};
+  std::vector<uint8_t> out;
+  for (big_integer const& a : values)
+    serialize(a, out);
+  EXPECT_EQ(0, out[0]);
+  uint8_t const* first = out.data();
+  uint8_t const* last = out.data() + out.size();
+  for (big_integer const& a : values)
+    EXPECT_EQ(a, deserialize(first, last));
+  EXPECT_EQ(last, first);
+  std::vector<uint8_t> truncated = {0x08, 1, 2};
+  first = truncated.data();
+  EXPECT_THROW(deserialize(first, first + truncated.size()), std::invalid_argument);
+  EXPECT_EQ(truncated.data(), first);
+  std::vector<uint8_t> endless(12, 0x80);
+  first = endless.data();
+  EXPECT_THROW(deserialize(first, first + endless.size()), std::invalid_argument);
+}
+
+TEST(performance, bytes) {
+  expect_growth(1000000 / performance_scale, 1, [](size_t n) {
+    big_integer a = -random_limbs(n);
+    return [a] {
+      std::vector<uint8_t> b = to_bytes(a, byte_order::big_endian, byte_format::twos_complement);
+      EXPECT_EQ(a, from_bytes(b.data(), b.size(), byte_order::big_endian, byte_format::twos_complement));
+    };
+  });
+}
+
+TEST(radix, matches_gmp) {
+  std::vector<big_integer> values = {0, 1, -1, 15, -16, 255, random_limbs(1), -random_limbs(2), random_limbs(17),
+                                     -random_limbs(64), (big_integer(1) << 160) - 1, big_integer(1) << 160};
+  for (big_integer const& a : values) {
+    mpz_t z;
+    mpz_init_set_str(z, to_string(a).c_str(), 10);
+    for (unsigned base = 2; base <= 36; ++base) {
+      std::vector<char> buf(mpz_sizeinbase(z, static_cast<int>(base)) + 2);
+      mpz_get_str(buf.data(), static_cast<int>(base), z);
+      std::string expected = buf.data();
+      EXPECT_EQ(expected, to_string(a, base));
+      EXPECT_EQ(a, from_string(expected, base));
+      std::string upper = expected;
+      std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+      EXPECT_EQ(a, from_string(upper, base));
+    }
+    mpz_clear(z);
+  }
+}
+
+TEST(radix, errors) {
+  EXPECT_EQ(255, from_string("+ff", 16));
+  EXPECT_EQ(-5, from_string("-101", 2));
+  EXPECT_EQ(0, from_string("-0000", 8));
+  EXPECT_EQ(1, from_string("0000000000000000000000000000000001", 16));
+  EXPECT_THROW(from_string("", 16), std::invalid_argument);
+  EXPECT_THROW(from_string("-", 16), std::invalid_argument);
+  EXPECT_THROW(from_string("12g", 16), std::invalid_argument);
+  EXPECT_THROW(from_string("2", 2), std::invalid_argument);
+  EXPECT_THROW(from_string("1", 37), std::invalid_argument);
+  EXPECT_THROW(to_string(big_integer(1), 1), std::invalid_argument);
+}
+
+TEST(performance, hex) {
+  expect_growth(1000000 / performance_scale, 1, [](size_t n) {
+    big_integer a = -random_limbs(n);
+    return [a] { EXPECT_EQ(a, from_string(to_string(a, 16), 16)); };
+  });
+}
+
+TEST(chars, round_trip_into_buffers) {
+  std::vector<big_integer> values = {0, 7, -7, random_limbs(5), -random_limbs(48), random_limbs(49), -random_limbs(300)};
+  for (big_integer const& a : values) {
+    for (unsigned base : {2u, 3u, 8u, 10u, 16u, 32u, 36u}) {
+      std::string expected = to_string(a, base);
+      size_t bound = max_chars(a, base);
+      EXPECT_LE(expected.size(), bound);
+      EXPECT_LE(bound, expected.size() + 2);
+      std::vector<char> buf(bound);
+      to_chars_result w = to_chars(buf.data(), buf.data() + buf.size(), a, base);
+      EXPECT_EQ(std::errc(), w.ec);
+      EXPECT_EQ(expected, std::string(buf.data(), w.ptr));
+      big_integer back = 12345;
+      from_chars_result r = from_chars(buf.data(), w.ptr, back, base);
+      EXPECT_EQ(std::errc(), r.ec);
+      EXPECT_EQ(w.ptr, r.ptr);
+      EXPECT_EQ(a, back);
+      to_chars_result small = to_chars(buf.data(), buf.data() + expected.size() - 1, a, base);
+      EXPECT_EQ(std::errc::value_too_large, small.ec);
+      EXPECT_EQ(buf.data() + expected.size() - 1, small.ptr);
+    }
+  }
+}
+
+TEST(chars, partial_input) {
+  std::string s = "-12ab  ";
+  big_integer x = 5;
+  from_chars_result r = from_chars(s.data(), s.data() + s.size(), x, 10);
+  EXPECT_EQ(std::errc(), r.ec);
+  EXPECT_EQ(s.data() + 3, r.ptr);
+  EXPECT_EQ(-12, x);
+  r = from_chars(s.data(), s.data() + s.size(), x, 16);
+  EXPECT_EQ(s.data() + 5, r.ptr);
+  EXPECT_EQ(-0x12ab, x);
+  r = from_chars(s.data() + 5, s.data() + s.size(), x, 10);
+  EXPECT_EQ(std::errc::invalid_argument, r.ec);
+  EXPECT_EQ(s.data() + 5, r.ptr);
+  EXPECT_EQ(-0x12ab, x);
+  r = from_chars(s.data(), s.data() + 1, x, 10);
+  EXPECT_EQ(std::errc::invalid_argument, r.ec);
+  EXPECT_EQ(s.data(), r.ptr);
+  char c = 0;
+  EXPECT_EQ(std::errc::value_too_large, to_chars(&c, &c, big_integer(0)).ec);
+  EXPECT_THROW(max_chars(big_integer(1), 37), std::invalid_argument);
+}
+
+TEST(chars, stream_formatting) {
+  big_integer a = -big_integer(0xbeef);
+  std::stringstream out;
+  out << a << ' ' << std::hex << a << ' ' << std::oct << a << ' ' << std::dec << std::setw(8) << a << '|'
+      << std::left << std::setw(8) << std::setfill('.') << a << '|' << std::hex << std::uppercase << a;
+  EXPECT_EQ("-48879 -beef -137357   -48879|-48879..|-BEEF", out.str());
+  std::stringstream large;
+  big_integer b = random_limbs(500);
+  large << b;
+  EXPECT_EQ(to_string(b), large.str());
+}
+
+TEST(istream, matches_constructor) {
+  for (size_t digits : {1, 9, 1023, 1024, 1025, 2048, 3 * 1024 + 5, 20000}) {
+    std::string s = random_digits(digits);
+    big_integer expected(s);
+    std::stringstream in("  -" + s + " +" + s + "\n" + s);
+    big_integer a, b, c;
+    in >> a >> b >> c;
+    EXPECT_TRUE(in.eof());
+    EXPECT_FALSE(in.fail());
+    EXPECT_EQ(-expected, a);
+    EXPECT_EQ(expected, b);
+    EXPECT_EQ(expected, c);
+  }
+}
+
+TEST(istream, bases_and_failures) {
+  big_integer x = random_limbs(700), y;
+  std::stringstream hex;
+  hex << std::hex << x << " -ff";
+  hex >> std::hex >> y;
+  EXPECT_EQ(x, y);
+  hex >> y;
+  EXPECT_EQ(-255, y);
+  std::stringstream oct("777 8");
+  oct >> std::oct >> y;
+  EXPECT_EQ(511, y);
+  oct >> y;
+  EXPECT_TRUE(oct.fail());
+  EXPECT_EQ(511, y);
+  std::stringstream rest("42abc");
+  rest >> y;
+  EXPECT_EQ(42, y);
+  EXPECT_FALSE(rest.fail());
+  rest.clear();
+  std::string word;
+  rest >> word;
+  EXPECT_EQ("abc", word);
+  std::stringstream empty("   ");
+  empty >> y;
+  EXPECT_TRUE(empty.fail());
+  std::stringstream sign("- 5");
+  sign >> y;
+  EXPECT_TRUE(sign.fail());
+  EXPECT_EQ(42, y);
+}
+
+TEST(performance, istream) {
+  expect_growth(100000 / performance_scale, 1.6, [](size_t n) {
+    std::string s = random_digits(n);
+    return [s] {
+      std::stringstream in(s);
+      big_integer x;
+      in >> x;
+      EXPECT_NE(0, x);
+    };
+  });
+}
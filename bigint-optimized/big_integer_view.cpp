@@ -0,0 +1,143 @@
+#include "big_integer_view.h"
+#include "limb_ops.h"
+#include <algorithm>
+#include <vector>
+
+big_integer_view::big_integer_view(big_integer const &a) : big_integer_view(a.sign, a.data(), a.size()) {}
+
+big_integer_view::big_integer_view(int sign, uint32_t const *limbs, size_t count) : d(limbs), n(count) {
+    while (n > 0 && d[n - 1] == 0) {
+        n--;
+    }
+    s = sign < 0 && n != 0 ? -1 : 1;
+}
+
+int compare(big_integer_view a, big_integer_view b) {
+    if (a.sign() != b.sign()) {
+        return a.sign();
+    }
+    int c;
+    if (a.size() != b.size()) {
+        c = a.size() < b.size() ? -1 : 1;
+    } else {
+        c = limbs::cmp(a.data(), b.data(), a.size());
+    }
+    return a.sign() * c;
+}
+
+bool operator==(big_integer_view a, big_integer_view b) {
+    return compare(a, b) == 0;
+}
+
+bool operator!=(big_integer_view a, big_integer_view b) {
+    return compare(a, b) != 0;
+}
+
+bool operator<(big_integer_view a, big_integer_view b) {
+    return compare(a, b) < 0;
+}
+
+bool operator>(big_integer_view a, big_integer_view b) {
+    return compare(a, b) > 0;
+}
+
+bool operator<=(big_integer_view a, big_integer_view b) {
+    return compare(a, b) <= 0;
+}
+
+bool operator>=(big_integer_view a, big_integer_view b) {
+    return compare(a, b) >= 0;
+}
+
+size_t bit_length(big_integer_view a) {
+    if (a.size() == 0) {
+        return 0;
+    }
+    return 32 * a.size() - __builtin_clz(a.data()[a.size() - 1]);
+}
+
+uint64_t bits_at(big_integer_view a, size_t shift) {
+    size_t limb = shift / 32;
+    uint128_t window = 0;
+    for (size_t i = 3; i-- > 0;) {
+        window <<= 32;
+        if (limb + i < a.size()) {
+            window |= a.data()[limb + i];
+        }
+    }
+    return static_cast<uint64_t>(window >> (shift % 32));
+}
+
+namespace {
+    // the two's complement limbs of a from the lowest up, sign limbs past the top; -|a| is ~(|a| - 1)
+    struct twos_complement {
+        explicit twos_complement(big_integer_view a) : a(a), borrow(a.sign() < 0 ? 1 : 0) {}
+
+        uint32_t next(size_t i) {
+            uint32_t x = i < a.size() ? a.data()[i] : 0;
+            if (a.sign() > 0) {
+                return x;
+            }
+            uint32_t y = x - borrow;
+            borrow = x < borrow ? 1 : 0;
+            return ~y;
+        }
+
+    private:
+        big_integer_view a;
+        uint32_t borrow;
+    };
+
+    big_integer bitwise(big_integer_view a, big_integer_view b, uint32_t (*f)(uint32_t, uint32_t)) {
+        // one limb above both operands holds only sign bits
+        size_t n = std::max(a.size(), b.size()) + 1;
+        std::vector<uint32_t> r(n);
+        twos_complement x(a), y(b);
+        for (size_t i = 0; i < n; i++) {
+            r[i] = f(x.next(i), y.next(i));
+        }
+        int sign = 1;
+        if (r[n - 1] >> 31) {
+            for (size_t i = 0; i < n; i++) {
+                r[i] = ~r[i];
+            }
+            limbs::add_1(r.data(), r.data(), n, 1);
+            sign = -1;
+        }
+        return big_integer(big_integer_view(sign, r.data(), n));
+    }
+}
+
+big_integer operator&(big_integer_view a, big_integer_view b) {
+    return bitwise(a, b, [](uint32_t x, uint32_t y) { return x & y; });
+}
+
+big_integer operator|(big_integer_view a, big_integer_view b) {
+    return bitwise(a, b, [](uint32_t x, uint32_t y) { return x | y; });
+}
+
+big_integer operator^(big_integer_view a, big_integer_view b) {
+    return bitwise(a, b, [](uint32_t x, uint32_t y) { return x ^ y; });
+}
+
+big_integer operator<<(big_integer_view a, int shift) {
+    big_integer r(a);
+    r <<= shift;
+    return r;
+}
+
+big_integer operator>>(big_integer_view a, int shift) {
+    big_integer r(a);
+    r >>= shift;
+    return r;
+}
+
+size_t hash_value(big_integer_view a) {
+    // FNV-1a over the significant limbs, the sign folded in last
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < a.size(); i++) {
+        h = (h ^ a.data()[i]) * 1099511628211ull;
+    }
+    h = (h ^ static_cast<uint64_t>(a.sign() < 0)) * 1099511628211ull;
+    return static_cast<size_t>(h ^ (h >> 32));
+}
@@ -0,0 +1,94 @@
+#ifndef BIG_INTEGER_VIEW_H
+#define BIG_INTEGER_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include "big_integer.h"
+
+// Sign and limbs of a value kept elsewhere, a big_integer, an mmap'd file or a network
+// buffer, for the read-only operations. Least significant limb first; the limbs are
+// not copied and must outlive the view.
+struct big_integer_view {
+    big_integer_view(big_integer const &a);
+
+    // high zero limbs are ignored, zero is zero whatever the sign
+    big_integer_view(int sign, uint32_t const *limbs, size_t n);
+
+    // 1 or -1, 1 for zero
+    int sign() const {
+        return s;
+    }
+
+    uint32_t const *data() const {
+        return d;
+    }
+
+    // number of significant limbs, 0 for zero
+    size_t size() const {
+        return n;
+    }
+
+private:
+    int s;
+    uint32_t const *d;
+    size_t n;
+};
+
+// -1, 0 or 1 as a is less than, equal to or greater than b
+int compare(big_integer_view a, big_integer_view b);
+
+bool operator==(big_integer_view a, big_integer_view b);
+
+bool operator!=(big_integer_view a, big_integer_view b);
+
+bool operator<(big_integer_view a, big_integer_view b);
+
+bool operator>(big_integer_view a, big_integer_view b);
+
+bool operator<=(big_integer_view a, big_integer_view b);
+
+bool operator>=(big_integer_view a, big_integer_view b);
+
+std::string to_string(big_integer_view a);
+
+std::ostream &operator<<(std::ostream &os, big_integer_view a);
+
+size_t bit_length(big_integer_view a);
+
+// 64 bits of |a| starting at bit shift, zeros past the top
+uint64_t bits_at(big_integer_view a, size_t shift);
+
+// two's complement bitwise operations and shifts, as for big_integer, into a new value
+big_integer operator&(big_integer_view a, big_integer_view b);
+
+big_integer operator|(big_integer_view a, big_integer_view b);
+
+big_integer operator^(big_integer_view a, big_integer_view b);
+
+big_integer operator<<(big_integer_view a, int shift);
+
+big_integer operator>>(big_integer_view a, int shift);
+
+// equal values hash equally, whether held by a big_integer or a view
+size_t hash_value(big_integer_view a);
+
+namespace std {
+    template<>
+    struct hash<big_integer_view> {
+        size_t operator()(big_integer_view a) const {
+            return hash_value(a);
+        }
+    };
+
+    template<>
+    struct hash<big_integer> {
+        size_t operator()(big_integer const &a) const {
+            return hash_value(a);
+        }
+    };
+}
+
+#endif //BIG_INTEGER_VIEW_H
@@ -0,0 +1,556 @@
+#include "limb_ops.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+static const uint32_t MAX_DEG = 32;
+
+uint32_t limbs::add_n(uint32_t *r, uint32_t const *a, uint32_t const *b, size_t n) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += static_cast<uint64_t>(a[i]) + b[i];
+        r[i] = static_cast<uint32_t>(carry);
+        carry >>= MAX_DEG;
+    }
+    return static_cast<uint32_t>(carry);
+}
+
+uint32_t limbs::add(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn) {
+    uint32_t carry = add_n(r, a, b, bn);
+    return add_1(r + bn, a + bn, an - bn, carry);
+}
+
+uint32_t limbs::add_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b) {
+    size_t i = 0;
+    for (; i < n && b != 0; i++) {
+        uint32_t sum = a[i] + b;
+        b = sum < b;
+        r[i] = sum;
+    }
+    if (r != a) {
+        std::copy(a + i, a + n, r + i);
+    }
+    return b;
+}
+
+uint32_t limbs::sub_n(uint32_t *r, uint32_t const *a, uint32_t const *b, size_t n) {
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t diff = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+        r[i] = static_cast<uint32_t>(diff);
+        borrow = static_cast<uint32_t>(diff >> 63);
+    }
+    return borrow;
+}
+
+uint32_t limbs::sub(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn) {
+    uint32_t borrow = sub_n(r, a, b, bn);
+    return sub_1(r + bn, a + bn, an - bn, borrow);
+}
+
+uint32_t limbs::sub_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b) {
+    size_t i = 0;
+    for (; i < n && b != 0; i++) {
+        uint32_t diff = a[i] - b;
+        b = a[i] < b;
+        r[i] = diff;
+    }
+    if (r != a) {
+        std::copy(a + i, a + n, r + i);
+    }
+    return b;
+}
+
+uint32_t limbs::mul_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += static_cast<uint64_t>(a[i]) * b;
+        r[i] = static_cast<uint32_t>(carry);
+        carry >>= MAX_DEG;
+    }
+    return static_cast<uint32_t>(carry);
+}
+
+uint32_t limbs::addmul_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += static_cast<uint64_t>(a[i]) * b + r[i];
+        r[i] = static_cast<uint32_t>(carry);
+        carry >>= MAX_DEG;
+    }
+    return static_cast<uint32_t>(carry);
+}
+
+uint32_t limbs::submul_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b) {
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t prod = static_cast<uint64_t>(a[i]) * b + borrow;
+        uint32_t low = static_cast<uint32_t>(prod);
+        borrow = static_cast<uint32_t>(prod >> MAX_DEG) + (r[i] < low);
+        r[i] -= low;
+    }
+    return borrow;
+}
+
+uint32_t limbs::lshift(uint32_t *r, uint32_t const *a, size_t n, unsigned s) {
+    if (s == 0) {
+        std::copy(a, a + n, r);
+        return 0;
+    }
+    uint32_t out = a[n - 1] >> (MAX_DEG - s);
+    for (size_t i = n - 1; i > 0; i--) {
+        r[i] = (a[i] << s) | (a[i - 1] >> (MAX_DEG - s));
+    }
+    r[0] = a[0] << s;
+    return out;
+}
+
+uint32_t limbs::rshift(uint32_t *r, uint32_t const *a, size_t n, unsigned s) {
+    if (s == 0) {
+        std::copy(a, a + n, r);
+        return 0;
+    }
+    uint32_t out = a[0] << (MAX_DEG - s);
+    for (size_t i = 0; i + 1 < n; i++) {
+        r[i] = (a[i] >> s) | (a[i + 1] << (MAX_DEG - s));
+    }
+    r[n - 1] = a[n - 1] >> s;
+    return out;
+}
+
+int limbs::cmp(uint32_t const *a, uint32_t const *b, size_t n) {
+    while (n-- > 0) {
+        if (a[n] != b[n]) {
+            return a[n] < b[n] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+size_t limbs::normalized_size(uint32_t const *a, size_t n) {
+    while (n > 1 && a[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+static void mul_basecase(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn) {
+    r[an] = limbs::mul_1(r, a, an, b[0]);
+    for (size_t j = 1; j < bn; j++) {
+        r[an + j] = limbs::addmul_1(r + j, a, an, b[j]);
+    }
+}
+
+static void sqr_basecase(uint32_t *r, uint32_t const *a, size_t n) {
+    std::fill(r, r + 2 * n, 0);
+    for (size_t i = 0; i + 1 < n; i++) {
+        r[n + i] = limbs::addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    }
+    uint32_t high = 0;
+    for (size_t i = 0; i < 2 * n; i++) {
+        uint32_t next = r[i] >> (MAX_DEG - 1);
+        r[i] = (r[i] << 1) | high;
+        high = next;
+    }
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t square = static_cast<uint64_t>(a[i]) * a[i];
+        carry += static_cast<uint64_t>(r[2 * i]) + static_cast<uint32_t>(square);
+        r[2 * i] = static_cast<uint32_t>(carry);
+        carry >>= MAX_DEG;
+        carry += static_cast<uint64_t>(r[2 * i + 1]) + (square >> MAX_DEG);
+        r[2 * i + 1] = static_cast<uint32_t>(carry);
+        carry >>= MAX_DEG;
+    }
+}
+
+// Three-prime NTT: convolution terms stay below 2^22 * 2^64, which the
+// product of the primes (about 2^86) recovers exactly through CRT.
+namespace {
+template<uint32_t P>
+struct ntt_field {
+    static uint32_t mul(uint32_t a, uint32_t b) {
+        return static_cast<uint32_t>(static_cast<uint64_t>(a) * b % P);
+    }
+
+    static uint32_t pow(uint32_t a, uint64_t e) {
+        uint32_t res = 1;
+        for (; e != 0; e >>= 1, a = mul(a, a)) {
+            if (e & 1) {
+                res = mul(res, a);
+            }
+        }
+        return res;
+    }
+
+    // a * w mod P with the precomputed w_shoup = floor(w * 2^32 / P), any a < 2^32
+    static uint32_t mul_shoup(uint32_t a, uint32_t w, uint32_t w_shoup) {
+        uint32_t q = static_cast<uint32_t>((static_cast<uint64_t>(a) * w_shoup) >> MAX_DEG);
+        uint32_t r = a * w - q * P;
+        return r >= P ? r - P : r;
+    }
+
+    // twiddles of the level with half-length h live in [h, 2h)
+    struct roots {
+        std::vector<uint32_t> w, w_shoup;
+
+        roots(size_t n, bool inverse) : w(n), w_shoup(n) {
+            uint32_t root = pow(3, (P - 1) / n);
+            if (inverse) {
+                root = pow(root, P - 2);
+            }
+            size_t h = n / 2;
+            uint32_t cur = 1;
+            for (size_t j = 0; j < h; j++, cur = mul(cur, root)) {
+                w[h + j] = cur;
+            }
+            for (h /= 2; h >= 1; h /= 2) {
+                for (size_t j = 0; j < h; j++) {
+                    w[h + j] = w[2 * (h + j)];
+                }
+            }
+            for (size_t j = 1; j < n; j++) {
+                w_shoup[j] = static_cast<uint32_t>((static_cast<uint64_t>(w[j]) << MAX_DEG) / P);
+            }
+        }
+    };
+
+    // runs butterflies k in [from, to) of the level with half-length h
+    template<typename F>
+    static void level(uint32_t *a, size_t n, size_t h, thread_pool *pool, F const &butterfly) {
+        parallel_for(pool, 0, n / 2, size_t(1) << 14, [a, h, &butterfly](size_t from, size_t to) {
+            for (size_t k = from; k < to;) {
+                size_t j = k & (h - 1);
+                uint32_t *block = a + 2 * (k - j);
+                size_t end = std::min(h, j + (to - k));
+                for (size_t t = j; t < end; t++) {
+                    butterfly(block + t, block + t + h, h + t);
+                }
+                k += end - j;
+            }
+        });
+    }
+
+    // natural order in, bit-reversed order out
+    static void forward(uint32_t *a, size_t n, roots const &r, thread_pool *pool) {
+        uint32_t const *w = r.w.data(), *ws = r.w_shoup.data();
+        for (size_t h = n / 2; h >= 1; h /= 2) {
+            level(a, n, h, pool, [w, ws](uint32_t *x, uint32_t *y, size_t t) {
+                uint32_t u = *x, v = *y;
+                uint32_t sum = u + v;
+                *x = sum >= P ? sum - P : sum;
+                *y = mul_shoup(u + P - v, w[t], ws[t]);
+            });
+        }
+    }
+
+    // bit-reversed order in, natural order out, without the 1/n factor
+    static void inverse(uint32_t *a, size_t n, roots const &r, thread_pool *pool) {
+        uint32_t const *w = r.w.data(), *ws = r.w_shoup.data();
+        for (size_t h = 1; h < n; h *= 2) {
+            level(a, n, h, pool, [w, ws](uint32_t *x, uint32_t *y, size_t t) {
+                uint32_t u = *x, v = mul_shoup(*y, w[t], ws[t]);
+                uint32_t sum = u + v;
+                *x = sum >= P ? sum - P : sum;
+                *y = u >= v ? u - v : u + P - v;
+            });
+        }
+    }
+
+    // c = a * b (or a * a when b is null) modulo P, n coefficients long
+    static void convolve(std::vector<uint32_t> &c, uint32_t const *a, size_t an, uint32_t const *b, size_t bn,
+                         size_t n, thread_pool *pool) {
+        roots fwd(n, false), inv(n, true);
+        c.assign(n, 0);
+        for (size_t i = 0; i < an; i++) {
+            c[i] = a[i] % P;
+        }
+        forward(c.data(), n, fwd, pool);
+        if (b == nullptr) {
+            for (size_t i = 0; i < n; i++) {
+                c[i] = mul(c[i], c[i]);
+            }
+        } else {
+            std::vector<uint32_t> d(n, 0);
+            for (size_t i = 0; i < bn; i++) {
+                d[i] = b[i] % P;
+            }
+            forward(d.data(), n, fwd, pool);
+            for (size_t i = 0; i < n; i++) {
+                c[i] = mul(c[i], d[i]);
+            }
+        }
+        inverse(c.data(), n, inv, pool);
+        uint32_t n_inv = pow(static_cast<uint32_t>(n % P), P - 2);
+        uint32_t n_inv_shoup = static_cast<uint32_t>((static_cast<uint64_t>(n_inv) << MAX_DEG) / P);
+        for (size_t i = 0; i < n; i++) {
+            c[i] = mul_shoup(c[i], n_inv, n_inv_shoup);
+        }
+    }
+};
+
+uint32_t const P1 = 998244353, P2 = 167772161, P3 = 469762049;
+size_t const NTT_MAX_LENGTH = size_t(1) << 23;
+
+void ntt_mul(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn, thread_pool *pool) {
+    size_t rn = an + (b == nullptr ? an : bn);
+    size_t n = 1;
+    while (n < rn - 1) {
+        n *= 2;
+    }
+    std::vector<uint32_t> c1, c2, c3;
+    {
+        thread_pool::task_group group(pool);
+        group.spawn([&] { ntt_field<P2>::convolve(c2, a, an, b, bn, n, pool); });
+        group.spawn([&] { ntt_field<P3>::convolve(c3, a, an, b, bn, n, pool); });
+        ntt_field<P1>::convolve(c1, a, an, b, bn, n, pool);
+        group.wait();
+    }
+    uint32_t const p1_inv = ntt_field<P2>::pow(P1 % P2, P2 - 2);
+    uint32_t const p12_inv = ntt_field<P3>::pow(static_cast<uint32_t>(static_cast<uint64_t>(P1) * P2 % P3), P3 - 2);
+    uint32_t const p1_mod3 = P1 % P3;
+    uint64_t const p12 = static_cast<uint64_t>(P1) * P2;
+    uint128_t carry = 0;
+    for (size_t i = 0; i < rn; i++) {
+        if (i + 1 < rn) {
+            uint32_t x1 = c1[i], x2 = c2[i], x3 = c3[i];
+            uint32_t k1 = ntt_field<P2>::mul((x2 + P2 - x1 % P2) % P2, p1_inv);
+            uint32_t low = static_cast<uint32_t>((x1 + static_cast<uint64_t>(p1_mod3) * k1) % P3);
+            uint32_t k2 = ntt_field<P3>::mul((x3 + P3 - low) % P3, p12_inv);
+            carry += x1 + static_cast<uint64_t>(P1) * k1 + static_cast<uint128_t>(p12) * k2;
+        }
+        r[i] = static_cast<uint32_t>(carry);
+        carry >>= MAX_DEG;
+    }
+}
+
+struct mul_context {
+    thread_pool *pool;
+    size_t cutoff;
+
+    bool parallel(size_t n) const {
+        return pool != nullptr && n >= cutoff;
+    }
+};
+
+// scratch needed by mul_rec with the larger operand of n limbs, sqr_rec fits in it as well
+size_t mul_scratch(size_t n) {
+    if (n < limbs::KARATSUBA_THRESHOLD) {
+        return 0;
+    }
+    size_t h = (n + 1) / 2;
+    return 4 * (h + 1) + mul_scratch(h + 1);
+}
+
+void mul_rec(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn,
+             uint32_t *scratch, mul_context const &ctx);
+
+void sqr_rec(uint32_t *r, uint32_t const *a, size_t n, uint32_t *scratch, mul_context const &ctx);
+
+// a is cut into pieces of bn limbs, every piece is a balanced product
+void mul_unbalanced(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn,
+                    uint32_t *scratch, mul_context const &ctx) {
+    if (ctx.parallel(bn)) {
+        size_t pieces = (an + bn - 1) / bn;
+        std::vector<std::vector<uint32_t>> products(pieces);
+        thread_pool::task_group group(ctx.pool);
+        for (size_t k = 1; k < pieces; k++) {
+            group.spawn([&, k] {
+                size_t len = std::min(bn, an - k * bn);
+                products[k].resize(len + bn);
+                std::vector<uint32_t> own(mul_scratch(bn));
+                mul_rec(products[k].data(), b, bn, a + k * bn, len, own.data(), ctx);
+            });
+        }
+        mul_rec(r, a, bn, b, bn, scratch, ctx);
+        group.wait();
+        for (size_t k = 1; k < pieces; k++) {
+            size_t len = products[k].size() - bn;
+            uint32_t carry = limbs::add_n(r + k * bn, r + k * bn, products[k].data(), bn);
+            limbs::add_1(r + (k + 1) * bn, products[k].data() + bn, len, carry);
+        }
+        return;
+    }
+    mul_rec(r, a, bn, b, bn, scratch, ctx);
+    uint32_t *product = scratch;
+    for (size_t offset = bn; offset < an; offset += bn) {
+        size_t len = std::min(bn, an - offset);
+        if (len >= bn) {
+            mul_rec(product, a + offset, len, b, bn, scratch + len + bn, ctx);
+        } else {
+            mul_rec(product, b, bn, a + offset, len, scratch + len + bn, ctx);
+        }
+        uint32_t carry = limbs::add_n(r + offset, r + offset, product, bn);
+        limbs::add_1(r + offset + bn, product + bn, len, carry);
+    }
+}
+
+// z1 = t - z0 - z2 added at r + h, where t = (a0 + a1)(b0 + b1) has 2h + 2 limbs
+void karatsuba_combine(uint32_t *r, size_t rn, size_t h, uint32_t *t) {
+    limbs::sub(t, t, 2 * h + 2, r, 2 * h);
+    limbs::sub(t, t, 2 * h + 2, r + 2 * h, rn - 2 * h);
+    size_t tn = std::min(2 * h + 2, rn - h);
+    limbs::add(r + h, r + h, rn - h, t, tn);
+}
+
+void mul_rec(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn,
+             uint32_t *scratch, mul_context const &ctx) {
+    if (bn < limbs::KARATSUBA_THRESHOLD) {
+        mul_basecase(r, a, an, b, bn);
+        return;
+    }
+    if (bn >= limbs::NTT_THRESHOLD && an + bn - 1 <= NTT_MAX_LENGTH) {
+        ntt_mul(r, a, an, b, bn, ctx.parallel(bn) ? ctx.pool : nullptr);
+        return;
+    }
+    size_t h = (an + 1) / 2;
+    if (bn <= h) {
+        mul_unbalanced(r, a, an, b, bn, scratch, ctx);
+        return;
+    }
+    uint32_t *sa = scratch;
+    uint32_t *sb = sa + h + 1;
+    uint32_t *t = sb + h + 1;
+    uint32_t *rest = t + 2 * h + 2;
+    sa[h] = limbs::add(sa, a, h, a + h, an - h);
+    sb[h] = limbs::add(sb, b, h, b + h, bn - h);
+    if (ctx.parallel(bn)) {
+        thread_pool::task_group group(ctx.pool);
+        group.spawn([&] {
+            std::vector<uint32_t> own(mul_scratch(h + 1));
+            mul_rec(r + 2 * h, a + h, an - h, b + h, bn - h, own.data(), ctx);
+        });
+        group.spawn([&] {
+            std::vector<uint32_t> own(mul_scratch(h + 1));
+            mul_rec(t, sa, h + 1, sb, h + 1, own.data(), ctx);
+        });
+        mul_rec(r, a, h, b, h, rest, ctx);
+        group.wait();
+    } else {
+        mul_rec(r, a, h, b, h, rest, ctx);
+        mul_rec(r + 2 * h, a + h, an - h, b + h, bn - h, rest, ctx);
+        mul_rec(t, sa, h + 1, sb, h + 1, rest, ctx);
+    }
+    karatsuba_combine(r, an + bn, h, t);
+}
+
+void sqr_rec(uint32_t *r, uint32_t const *a, size_t n, uint32_t *scratch, mul_context const &ctx) {
+    if (n < limbs::KARATSUBA_THRESHOLD) {
+        sqr_basecase(r, a, n);
+        return;
+    }
+    if (n >= limbs::NTT_THRESHOLD && 2 * n - 1 <= NTT_MAX_LENGTH) {
+        ntt_mul(r, a, n, nullptr, 0, ctx.parallel(n) ? ctx.pool : nullptr);
+        return;
+    }
+    size_t h = (n + 1) / 2;
+    uint32_t *sa = scratch;
+    uint32_t *t = sa + 2 * h + 2;
+    uint32_t *rest = t + 2 * h + 2;
+    sa[h] = limbs::add(sa, a, h, a + h, n - h);
+    if (ctx.parallel(n)) {
+        thread_pool::task_group group(ctx.pool);
+        group.spawn([&] {
+            std::vector<uint32_t> own(mul_scratch(h + 1));
+            sqr_rec(r + 2 * h, a + h, n - h, own.data(), ctx);
+        });
+        group.spawn([&] {
+            std::vector<uint32_t> own(mul_scratch(h + 1));
+            sqr_rec(t, sa, h + 1, own.data(), ctx);
+        });
+        sqr_rec(r, a, h, rest, ctx);
+        group.wait();
+    } else {
+        sqr_rec(r, a, h, rest, ctx);
+        sqr_rec(r + 2 * h, a + h, n - h, rest, ctx);
+        sqr_rec(t, sa, h + 1, rest, ctx);
+    }
+    karatsuba_combine(r, 2 * n, h, t);
+}
+}
+
+void limbs::mul(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn, thread_pool *pool) {
+    mul_context ctx = {pool, thread_pool::parallel_cutoff()};
+    std::vector<uint32_t> scratch(mul_scratch(an));
+    mul_rec(r, a, an, b, bn, scratch.data(), ctx);
+}
+
+void limbs::sqr(uint32_t *r, uint32_t const *a, size_t n, thread_pool *pool) {
+    mul_context ctx = {pool, thread_pool::parallel_cutoff()};
+    std::vector<uint32_t> scratch(mul_scratch(n));
+    sqr_rec(r, a, n, scratch.data(), ctx);
+}
+
+size_t limbs::sqr_scratch(size_t n) {
+    return mul_scratch(n);
+}
+
+void limbs::sqr(uint32_t *r, uint32_t const *a, size_t n, uint32_t *scratch, thread_pool *pool) {
+    mul_context ctx = {pool, thread_pool::parallel_cutoff()};
+    sqr_rec(r, a, n, scratch, ctx);
+}
+
+uint32_t limbs::divrem_1(uint32_t *q, uint32_t const *a, size_t n, uint32_t d) {
+    uint64_t rem = 0;
+    for (size_t i = n; i-- > 0;) {
+        uint64_t cur = (rem << MAX_DEG) | a[i];
+        q[i] = static_cast<uint32_t>(cur / d);
+        rem = cur % d;
+    }
+    return static_cast<uint32_t>(rem);
+}
+
+void limbs::mod_1s(uint32_t *r, uint32_t const *a, size_t n, uint32_t const *d, size_t count) {
+    // the divisions by different d[i] are independent and overlap in the pipeline
+    const size_t block = 8;
+    for (size_t j = 0; j < count; j += block) {
+        size_t k = std::min(block, count - j);
+        uint64_t rem[block] = {};
+        for (size_t i = n; i-- > 0;) {
+            for (size_t t = 0; t < k; t++) {
+                rem[t] = ((rem[t] << MAX_DEG) | a[i]) % d[j + t];
+            }
+        }
+        for (size_t t = 0; t < k; t++) {
+            r[j + t] = static_cast<uint32_t>(rem[t]);
+        }
+    }
+}
+
+// Knuth's algorithm D on a divisor normalized to a set top bit
+void limbs::divrem(uint32_t *q, uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn) {
+    if (bn == 1) {
+        r[0] = divrem_1(q, a, an, b[0]);
+        return;
+    }
+    unsigned s = static_cast<unsigned>(__builtin_clz(b[bn - 1]));
+    std::vector<uint32_t> v(bn), u(an + 1);
+    lshift(v.data(), b, bn, s);
+    u[an] = lshift(u.data(), a, an, s);
+    uint64_t const base = uint64_t(1) << MAX_DEG;
+    uint64_t const high = v[bn - 1], low = v[bn - 2];
+    for (size_t j = an - bn + 1; j-- > 0;) {
+        uint64_t num = (static_cast<uint64_t>(u[j + bn]) << MAX_DEG) | u[j + bn - 1];
+        uint64_t qhat = num / high;
+        uint64_t rhat = num % high;
+        while (qhat >= base || qhat * low > ((rhat << MAX_DEG) | u[j + bn - 2])) {
+            qhat--;
+            rhat += high;
+            if (rhat >= base) {
+                break;
+            }
+        }
+        uint32_t borrow = submul_1(u.data() + j, v.data(), bn, static_cast<uint32_t>(qhat));
+        uint32_t top = u[j + bn];
+        u[j + bn] = top - borrow;
+        if (top < borrow) {
+            qhat--;
+            u[j + bn] += add_n(u.data() + j, u.data() + j, v.data(), bn);
+        }
+        q[j] = static_cast<uint32_t>(qhat);
+    }
+    rshift(r, u.data(), bn, s);
+}
@@ -0,0 +1,79 @@
+#ifndef LIMB_OPS_H
+#define LIMB_OPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct thread_pool;
+
+// Kernels on little-endian arrays of 32-bit limbs. Sizes are at least 1 and,
+// unless said otherwise, the result may not overlap the operands.
+namespace limbs {
+    // below this many limbs of the smaller operand schoolbook multiplication wins
+    size_t const KARATSUBA_THRESHOLD = 32;
+
+    // from this many limbs of the smaller operand on products go through three-prime NTT
+    size_t const NTT_THRESHOLD = 3584;
+
+    // r = a + b, returns the carry; r may be a or b
+    uint32_t add_n(uint32_t *r, uint32_t const *a, uint32_t const *b, size_t n);
+
+    // r = a + b for an >= bn, returns the carry; r may be a
+    uint32_t add(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn);
+
+    // r = a + b for a single limb b, returns the carry; r may be a
+    uint32_t add_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b);
+
+    // r = a - b, returns the borrow; r may be a or b
+    uint32_t sub_n(uint32_t *r, uint32_t const *a, uint32_t const *b, size_t n);
+
+    // r = a - b for an >= bn, returns the borrow; r may be a
+    uint32_t sub(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn);
+
+    // r = a - b for a single limb b, returns the borrow; r may be a
+    uint32_t sub_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b);
+
+    // r = a * b, returns the high limb; r may be a
+    uint32_t mul_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b);
+
+    // r += a * b over n limbs, returns the carry out of r[n - 1]
+    uint32_t addmul_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b);
+
+    // r -= a * b over n limbs, returns the borrow out of r[n - 1]
+    uint32_t submul_1(uint32_t *r, uint32_t const *a, size_t n, uint32_t b);
+
+    // r = a << s for s < 32, returns the bits shifted out; r may be a
+    uint32_t lshift(uint32_t *r, uint32_t const *a, size_t n, unsigned s);
+
+    // r = a >> s for s < 32, returns the bits shifted out in the high end of a limb; r may be a
+    uint32_t rshift(uint32_t *r, uint32_t const *a, size_t n, unsigned s);
+
+    int cmp(uint32_t const *a, uint32_t const *b, size_t n);
+
+    // size without leading zero limbs, at least 1
+    size_t normalized_size(uint32_t const *a, size_t n);
+
+    // r[0, an + bn) = a * b for an >= bn; a pool lets the top levels run in parallel
+    void mul(uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn, thread_pool *pool = nullptr);
+
+    // r[0, 2n) = a * a
+    void sqr(uint32_t *r, uint32_t const *a, size_t n, thread_pool *pool = nullptr);
+
+    // limbs of scratch the sqr below needs for operands of up to n limbs
+    size_t sqr_scratch(size_t n);
+
+    // sqr in caller scratch of at least sqr_scratch(n) limbs, for loops that square again and again;
+    // the parallel halves and three-prime NTT products still take their own memory
+    void sqr(uint32_t *r, uint32_t const *a, size_t n, uint32_t *scratch, thread_pool *pool = nullptr);
+
+    // q = a / d, returns a % d; q may be a
+    uint32_t divrem_1(uint32_t *q, uint32_t const *a, size_t n, uint32_t d);
+
+    // r[i] = a % d[i] for count divisors in one pass over a
+    void mod_1s(uint32_t *r, uint32_t const *a, size_t n, uint32_t const *d, size_t count);
+
+    // q[0, an - bn + 1) = a / b and r[0, bn) = a % b for an >= bn and b[bn - 1] != 0; r may be a
+    void divrem(uint32_t *q, uint32_t *r, uint32_t const *a, size_t an, uint32_t const *b, size_t bn);
+}
+
+#endif //LIMB_OPS_H
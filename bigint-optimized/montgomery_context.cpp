@@ -0,0 +1,172 @@
+#include "montgomery_context.h"
+#include "limb_ops.h"
+#include <algorithm>
+#include <stdexcept>
+
+// from this many limbs on reduction goes through two full products instead of n limb steps
+static const size_t REDC_PRODUCT_THRESHOLD = 384;
+
+montgomery_context::montgomery_context(big_integer const &modulus) : m(modulus), n(modulus.size()) {
+    if (m.sign < 0 || (m.val[0] & 1) == 0) {
+        throw std::invalid_argument("montgomery_context: modulus must be odd and positive");
+    }
+    uint32_t const *md = m.data();
+
+    // Newton iteration doubles the number of correct bits: x = x * (2 - m * x)
+    uint32_t x = md[0];
+    for (int i = 0; i < 4; i++) {
+        x *= 2 - md[0] * x;
+    }
+    m_inv_limb = -x;
+
+    std::vector<uint32_t> inv(n, 0), e(2 * n), p(2 * n);
+    inv[0] = x;
+    for (size_t k = 1; k < n; k *= 2) {
+        size_t k2 = std::min(2 * k, n);
+        // m * inv = 1 + d * 2^(32k), and inv * (2 - m * inv) = inv - inv * d * 2^(32k)
+        limbs::mul(e.data(), md, k2, inv.data(), k);
+        size_t dn = k2 - k;
+        limbs::mul(p.data(), inv.data(), dn, e.data() + k, dn);
+        for (size_t i = 0; i < dn; i++) {
+            inv[k + i] = ~p[i];
+        }
+        limbs::add_1(inv.data() + k, inv.data() + k, dn, 1);
+    }
+    store(m_inv, inv.data());
+
+    big_integer q;
+    divmod_abs(big_integer(1) << static_cast<int>(32 * n), m, q, r1);
+    divmod_abs(big_integer(1) << static_cast<int>(64 * n), m, q, r2);
+}
+
+void montgomery_context::store(big_integer &r, uint32_t const *src) const {
+    r.val.resize(n);
+    std::copy(src, src + n, r.val.data());
+    r.sign = 1;
+    r.shrink_to_fit();
+}
+
+void montgomery_context::check_width(big_integer const &a) const {
+    if (a.size() > n) {
+        throw std::invalid_argument("montgomery_context: operand wider than the modulus");
+    }
+}
+
+void montgomery_context::reduce(big_integer &r, uint32_t *t, scratch &s) const {
+    uint32_t const *md = m.data();
+    uint32_t *high = t + n;
+    if (n < REDC_PRODUCT_THRESHOLD) {
+        uint32_t top = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint32_t carry = limbs::addmul_1(t + i, md, n, t[i] * m_inv_limb);
+            top += limbs::add_1(t + i + n, t + i + n, n - i, carry);
+        }
+        if (top != 0 || limbs::cmp(high, md, n) >= 0) {
+            limbs::sub_n(high, high, md, n);
+        }
+    } else {
+        // q = t * m^-1 mod R makes the low half of t - q * m vanish, the high half lies in (-m, m)
+        uint32_t *q = s.limbs.data() + 2 * n;
+        uint32_t *qm = q + 2 * n;
+        size_t inv_n = m_inv.size();
+        limbs::mul(q, t, n, m_inv.data(), inv_n);
+        size_t qn = limbs::normalized_size(q, n);
+        std::fill(qm + n + qn, qm + 2 * n, 0);
+        limbs::mul(qm, md, n, q, qn);
+        if (limbs::sub_n(high, high, qm + n, n) != 0) {
+            limbs::add_n(high, high, md, n);
+        }
+    }
+    store(r, high);
+}
+
+void montgomery_context::mul(big_integer &r, big_integer const &a, big_integer const &b, scratch &s) const {
+    check_width(a);
+    check_width(b);
+    s.limbs.resize(6 * n);
+    uint32_t *t = s.limbs.data();
+    size_t an = a.size(), bn = b.size();
+    if (a.data() == b.data() && an == bn) {
+        limbs::sqr(t, a.data(), an);
+    } else if (an >= bn) {
+        limbs::mul(t, a.data(), an, b.data(), bn);
+    } else {
+        limbs::mul(t, b.data(), bn, a.data(), an);
+    }
+    std::fill(t + an + bn, t + 2 * n, 0);
+    reduce(r, t, s);
+}
+
+void montgomery_context::sqr(big_integer &r, big_integer const &a, scratch &s) const {
+    mul(r, a, a, s);
+}
+
+void montgomery_context::add(big_integer &r, big_integer const &a, big_integer const &b, scratch &s) const {
+    check_width(a);
+    check_width(b);
+    s.limbs.resize(6 * n);
+    uint32_t *t = s.limbs.data();
+    std::fill(std::copy(a.data(), a.data() + a.size(), t), t + n, 0);
+    uint32_t carry = limbs::add(t, t, n, b.data(), b.size());
+    if (carry != 0 || limbs::cmp(t, m.data(), n) >= 0) {
+        limbs::sub_n(t, t, m.data(), n);
+    }
+    store(r, t);
+}
+
+void montgomery_context::sub(big_integer &r, big_integer const &a, big_integer const &b, scratch &s) const {
+    check_width(a);
+    check_width(b);
+    s.limbs.resize(6 * n);
+    uint32_t *t = s.limbs.data();
+    std::fill(std::copy(a.data(), a.data() + a.size(), t), t + n, 0);
+    if (limbs::sub(t, t, n, b.data(), b.size()) != 0) {
+        limbs::add_n(t, t, m.data(), n);
+    }
+    store(r, t);
+}
+
+big_integer montgomery_context::to_montgomery(big_integer const &a) const {
+    big_integer q, x;
+    divmod_abs(a, m, q, x);
+    if (a.sign < 0 && x != 0) {
+        x = m - x;
+    }
+    return mul(x, r2);
+}
+
+big_integer montgomery_context::from_montgomery(big_integer const &a) const {
+    check_width(a);
+    scratch s;
+    s.limbs.resize(6 * n);
+    uint32_t *t = s.limbs.data();
+    std::copy(a.data(), a.data() + a.size(), t);
+    big_integer r;
+    reduce(r, t, s);
+    return r;
+}
+
+big_integer montgomery_context::mul(big_integer const &a, big_integer const &b) const {
+    scratch s;
+    big_integer r;
+    mul(r, a, b, s);
+    return r;
+}
+
+big_integer montgomery_context::sqr(big_integer const &a) const {
+    return mul(a, a);
+}
+
+big_integer montgomery_context::add(big_integer const &a, big_integer const &b) const {
+    scratch s;
+    big_integer r;
+    add(r, a, b, s);
+    return r;
+}
+
+big_integer montgomery_context::sub(big_integer const &a, big_integer const &b) const {
+    scratch s;
+    big_integer r;
+    sub(r, a, b, s);
+    return r;
+}
@@ -0,0 +1,79 @@
+#ifndef MONTGOMERY_CONTEXT_H
+#define MONTGOMERY_CONTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+
+// Arithmetic modulo a fixed odd m > 0 of n limbs. Residues are kept in Montgomery
+// form x * R mod m with R = 2^(32n), as big_integer values in [0, m), which lets
+// products be reduced without a single division. Operands outside [0, m) give
+// unspecified results, to_montgomery brings any value into range; operands of
+// more than n limbs make mul, sqr, add, sub and from_montgomery throw
+// std::invalid_argument.
+struct montgomery_context {
+    // working memory of the in-place operations, reusing it between calls
+    // saves the allocations; one scratch per thread
+    struct scratch {
+        std::vector<uint32_t> limbs;
+    };
+
+    // throws std::invalid_argument unless the modulus is odd and positive
+    explicit montgomery_context(big_integer const &modulus);
+
+    big_integer const &modulus() const {
+        return m;
+    }
+
+    // number of limbs of the modulus
+    size_t size() const {
+        return n;
+    }
+
+    // R mod m, the Montgomery form of 1
+    big_integer const &one() const {
+        return r1;
+    }
+
+    big_integer to_montgomery(big_integer const &a) const;
+
+    big_integer from_montgomery(big_integer const &a) const;
+
+    // r = a * b * R^-1 mod m; r may be a or b
+    void mul(big_integer &r, big_integer const &a, big_integer const &b, scratch &s) const;
+
+    void sqr(big_integer &r, big_integer const &a, scratch &s) const;
+
+    // r = a + b mod m, the same in and out of Montgomery form
+    void add(big_integer &r, big_integer const &a, big_integer const &b, scratch &s) const;
+
+    void sub(big_integer &r, big_integer const &a, big_integer const &b, scratch &s) const;
+
+    big_integer mul(big_integer const &a, big_integer const &b) const;
+
+    big_integer sqr(big_integer const &a) const;
+
+    big_integer add(big_integer const &a, big_integer const &b) const;
+
+    big_integer sub(big_integer const &a, big_integer const &b) const;
+
+private:
+    // r = t * R^-1 mod m for t < m * R of 2n limbs, t is clobbered
+    void reduce(big_integer &r, uint32_t *t, scratch &s) const;
+
+    void store(big_integer &r, uint32_t const *src) const;
+
+    void check_width(big_integer const &a) const;
+
+    big_integer m;
+    size_t n;
+    // -m^-1 mod 2^32 for the limb by limb reduction
+    uint32_t m_inv_limb;
+    // m^-1 mod R for the reduction through full products
+    big_integer m_inv;
+    big_integer r1;
+    big_integer r2;
+};
+
+#endif //MONTGOMERY_CONTEXT_H
@@ -0,0 +1,210 @@
+#include "rns_integer.h"
+#include "big_integer_math.h"
+#include "big_integer_view.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    uint32_t pow_mod_32(uint64_t b, uint64_t e, uint32_t m) {
+        uint64_t res = 1;
+        while (e != 0) {
+            if (e & 1) {
+                res = res * b % m;
+            }
+            b = b * b % m;
+            e >>= 1;
+        }
+        return static_cast<uint32_t>(res);
+    }
+
+    // Miller-Rabin to the bases 2, 7 and 61 is exact below 4759123141
+    bool is_prime_31(uint32_t n) {
+        uint32_t d = n - 1;
+        int twos = 0;
+        while (d % 2 == 0) {
+            d /= 2;
+            twos++;
+        }
+        for (uint32_t a : {2u, 7u, 61u}) {
+            uint64_t x = pow_mod_32(a, d, n);
+            if (x == 1 || x == n - 1) {
+                continue;
+            }
+            int i = 1;
+            for (; i < twos; i++) {
+                x = x * x % n;
+                if (x == n - 1) {
+                    break;
+                }
+            }
+            if (i == twos) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // t * 2^-32 mod p for t < p^2, the result in [0, p); p < 2^31 keeps t + m * p in 64 bits
+    inline uint32_t redc(uint64_t t, uint32_t p, uint32_t neg_inv) {
+        uint32_t m = static_cast<uint32_t>(t) * neg_inv;
+        auto u = static_cast<uint32_t>((t + static_cast<uint64_t>(m) * p) >> 32);
+        return std::min(u, u - p);
+    }
+
+    uint32_t to_uint32(big_integer const &a) {
+        return static_cast<uint32_t>(bits_at(a, 0));
+    }
+}
+
+rns_basis::rns_basis(size_t count) {
+    if (count == 0) {
+        throw std::invalid_argument("rns_basis: no primes");
+    }
+    for (uint32_t p = (1u << 31) - 1; primes.size() < count; p -= 2) {
+        if (is_prime_31(p)) {
+            primes.push_back(p);
+        }
+    }
+    std::vector<big_integer> squares;
+    for (uint32_t p : primes) {
+        uint32_t x = p;
+        for (int i = 0; i < 4; i++) {
+            x *= 2 - p * x;
+        }
+        neg_inv.push_back(-x);
+        r2.push_back(static_cast<uint32_t>((UINT64_MAX % p + 1) % p));
+        prime_values.push_back(big_integer(p));
+        squares.push_back(big_integer(p) * big_integer(p));
+    }
+    // the product tree over a power of two of leaves, the padding leaves are 1
+    size_t leaf_base = 1;
+    while (leaf_base < count) {
+        leaf_base *= 2;
+    }
+    nodes.assign(2 * leaf_base, big_integer(1));
+    std::copy(prime_values.begin(), prime_values.end(), nodes.begin() + leaf_base);
+    for (size_t node = leaf_base; node-- > 1;) {
+        nodes[node] = nodes[2 * node] * nodes[2 * node + 1];
+    }
+    half = nodes[1] >> 1;
+
+    // (M / p) mod p = (M mod p^2) / p
+    std::vector<big_integer> rems = remainders(nodes[1], squares);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t p = primes[i];
+        uint32_t cofactor = to_uint32(rems[i] / prime_values[i]);
+        uint32_t inv = pow_mod_32(cofactor, p - 2, p);
+        crt.push_back(redc(uint64_t(inv) * r2[i], p, neg_inv[i]));
+    }
+}
+
+big_integer rns_basis::combine(uint32_t const *c, size_t node, size_t from, size_t to) const {
+    if (from >= primes.size()) {
+        return 0;
+    }
+    if (to - from == 1) {
+        return big_integer(c[from]);
+    }
+    size_t mid = from + (to - from) / 2;
+    std::shared_ptr<thread_pool> pool;
+    if (bit_length(nodes[node]) >= 32 * thread_pool::parallel_cutoff()) {
+        pool = thread_pool::instance();
+    }
+    big_integer low, high;
+    thread_pool::task_group group(pool.get());
+    group.spawn([&] { low = combine(c, 2 * node, from, mid); });
+    high = combine(c, 2 * node + 1, mid, to);
+    group.wait();
+    return low * nodes[2 * node + 1] + high * nodes[2 * node];
+}
+
+rns_integer::rns_integer(std::shared_ptr<rns_basis const> basis, big_integer const &value)
+        : b(std::move(basis)), r(b->size()) {
+    std::vector<big_integer> rems = remainders(value, b->prime_values);
+    for (size_t i = 0; i < r.size(); i++) {
+        r[i] = redc(uint64_t(to_uint32(rems[i])) * b->r2[i], b->primes[i], b->neg_inv[i]);
+    }
+}
+
+uint32_t rns_integer::residue(size_t i) const {
+    return redc(r[i], b->primes[i], b->neg_inv[i]);
+}
+
+big_integer rns_integer::to_big_integer() const {
+    // c_i = r_i * (M / p_i)^-1 mod p_i, and x = sum c_i * (M / p_i) mod M
+    size_t n = r.size();
+    std::vector<uint32_t> c(n);
+    uint32_t const *p = b->primes.data(), *ni = b->neg_inv.data(), *w = b->crt.data();
+    for (size_t i = 0; i < n; i++) {
+        c[i] = redc(redc(uint64_t(r[i]) * w[i], p[i], ni[i]), p[i], ni[i]);
+    }
+    big_integer x = b->combine(c.data(), 1, 0, b->nodes.size() / 2);
+    big_integer const &m = b->modulus();
+    x %= m;
+    return x > b->half ? x - m : x;
+}
+
+void rns_integer::check_basis(rns_integer const &rhs) const {
+    if (b != rhs.b) {
+        throw std::invalid_argument("rns_integer: different bases");
+    }
+}
+
+rns_integer &rns_integer::operator+=(rns_integer const &rhs) {
+    check_basis(rhs);
+    size_t n = r.size();
+    uint32_t *x = r.data();
+    uint32_t const *y = rhs.r.data(), *p = b->primes.data();
+    for (size_t i = 0; i < n; i++) {
+        uint32_t s = x[i] + y[i];
+        x[i] = std::min(s, s - p[i]);
+    }
+    return *this;
+}
+
+rns_integer &rns_integer::operator-=(rns_integer const &rhs) {
+    check_basis(rhs);
+    size_t n = r.size();
+    uint32_t *x = r.data();
+    uint32_t const *y = rhs.r.data(), *p = b->primes.data();
+    for (size_t i = 0; i < n; i++) {
+        uint32_t d = x[i] - y[i];
+        x[i] = std::min(d, d + p[i]);
+    }
+    return *this;
+}
+
+rns_integer &rns_integer::operator*=(rns_integer const &rhs) {
+    check_basis(rhs);
+    size_t n = r.size();
+    uint32_t *x = r.data();
+    uint32_t const *y = rhs.r.data(), *p = b->primes.data(), *ni = b->neg_inv.data();
+    for (size_t i = 0; i < n; i++) {
+        x[i] = redc(uint64_t(x[i]) * y[i], p[i], ni[i]);
+    }
+    return *this;
+}
+
+rns_integer rns_integer::operator-() const {
+    rns_integer res = *this;
+    uint32_t const *p = b->primes.data();
+    for (size_t i = 0; i < res.r.size(); i++) {
+        uint32_t d = 0 - res.r[i];
+        res.r[i] = std::min(d, d + p[i]);
+    }
+    return res;
+}
+
+rns_integer operator+(rns_integer a, rns_integer const &b) {
+    return a += b;
+}
+
+rns_integer operator-(rns_integer a, rns_integer const &b) {
+    return a -= b;
+}
+
+rns_integer operator*(rns_integer a, rns_integer const &b) {
+    return a *= b;
+}
@@ -0,0 +1,86 @@
+#ifndef RNS_INTEGER_H
+#define RNS_INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "big_integer.h"
+
+// A residue number system: the largest primes below 2^31 and everything that the
+// conversions need precomputed, the product tree of the primes and the CRT weights.
+// Values in (-M / 2, M / 2] are represented, M being the product of the primes.
+struct rns_basis {
+    // throws std::invalid_argument for count == 0
+    explicit rns_basis(size_t count);
+
+    size_t size() const {
+        return primes.size();
+    }
+
+    uint32_t prime(size_t i) const {
+        return primes[i];
+    }
+
+    big_integer const &modulus() const {
+        return nodes[1];
+    }
+
+private:
+    friend struct rns_integer;
+
+    // sum of c_i * (P / p_i) over the leaves [from, to) below node, P their product
+    big_integer combine(uint32_t const *c, size_t node, size_t from, size_t to) const;
+
+    std::vector<uint32_t> primes;
+    std::vector<big_integer> prime_values;
+    // -p^-1 mod 2^32, for the Montgomery products with R = 2^32
+    std::vector<uint32_t> neg_inv;
+    // R^2 mod p, brings a residue into Montgomery form
+    std::vector<uint32_t> r2;
+    // (M / p)^-1 mod p in Montgomery form
+    std::vector<uint32_t> crt;
+    // product tree of the primes in heap order, node 1 is M and the leaves start at size / 2
+    std::vector<big_integer> nodes;
+    big_integer half;
+};
+
+// An integer as its residues modulo every prime of a basis, kept in Montgomery form.
+// Arithmetic is elementwise over plain arrays without branches, so that the compiler
+// vectorises it; results are exact while they stay within the range of the basis.
+struct rns_integer {
+    rns_integer(std::shared_ptr<rns_basis const> basis, big_integer const &value);
+
+    std::shared_ptr<rns_basis const> const &basis() const {
+        return b;
+    }
+
+    // residue modulo basis()->prime(i), in [0, prime(i))
+    uint32_t residue(size_t i) const;
+
+    // the value in (-M / 2, M / 2], by a CRT product tree
+    big_integer to_big_integer() const;
+
+    // operands of different bases throw std::invalid_argument
+    rns_integer &operator+=(rns_integer const &rhs);
+
+    rns_integer &operator-=(rns_integer const &rhs);
+
+    rns_integer &operator*=(rns_integer const &rhs);
+
+    rns_integer operator-() const;
+
+private:
+    void check_basis(rns_integer const &rhs) const;
+
+    std::shared_ptr<rns_basis const> b;
+    std::vector<uint32_t> r;
+};
+
+rns_integer operator+(rns_integer a, rns_integer const &b);
+
+rns_integer operator-(rns_integer a, rns_integer const &b);
+
+rns_integer operator*(rns_integer a, rns_integer const &b);
+
+#endif //RNS_INTEGER_H
@@ -0,0 +1,207 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+struct thread_pool::group_state {
+    std::atomic<size_t> pending;
+    std::mutex lock;
+    std::exception_ptr error;
+
+    group_state() : pending(0) {}
+};
+
+static thread_local thread_pool const *current_pool = nullptr;
+static thread_local size_t current_index = 0;
+
+thread_pool::thread_pool(size_t threads) : queued(0), next_queue(0), stopping(false) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    // one deque per worker plus a shared one for threads outside of the pool
+    for (size_t i = 0; i < threads; i++) {
+        queues.emplace_back(new queue());
+    }
+    for (size_t i = 0; i + 1 < threads; i++) {
+        workers.emplace_back([this, i] { work(i); });
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+size_t thread_pool::current_queue() const {
+    return current_pool == this ? current_index : queues.size() - 1;
+}
+
+void thread_pool::push(task t) {
+    queue &q = *queues[current_queue()];
+    {
+        std::lock_guard<std::mutex> guard(q.lock);
+        q.tasks.push_back(std::move(t));
+    }
+    queued++;
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+    }
+    wake.notify_one();
+}
+
+bool thread_pool::try_run(size_t self) {
+    task t;
+    bool found = false;
+    {
+        queue &own = *queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            t = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    size_t start = next_queue++;
+    for (size_t i = 0; i < queues.size() && !found; i++) {
+        queue &victim = *queues[(start + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            t = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    queued--;
+    try {
+        t.f();
+    } catch (...) {
+        std::lock_guard<std::mutex> guard(t.group->lock);
+        if (!t.group->error) {
+            t.group->error = std::current_exception();
+        }
+    }
+    if (--t.group->pending == 0) {
+        // the owner of the group may be asleep in wait
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+        }
+        wake.notify_all();
+    }
+    return true;
+}
+
+void thread_pool::work(size_t self) {
+    current_pool = this;
+    current_index = self;
+    while (true) {
+        if (try_run(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+thread_pool::task_group::task_group(thread_pool *pool) : pool(pool), state(std::make_shared<group_state>()) {}
+
+thread_pool::task_group::~task_group() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void thread_pool::task_group::spawn(std::function<void()> f) {
+    if (pool == nullptr) {
+        f();
+        return;
+    }
+    state->pending++;
+    task t;
+    t.f = std::move(f);
+    t.group = state;
+    pool->push(std::move(t));
+}
+
+void thread_pool::task_group::wait() {
+    if (pool != nullptr) {
+        size_t self = pool->current_queue();
+        while (state->pending > 0) {
+            if (pool->try_run(self)) {
+                continue;
+            }
+            // the remaining tasks run elsewhere, sleep until they finish or new work shows up
+            std::unique_lock<std::mutex> guard(pool->sleep_lock);
+            pool->wake.wait(guard, [this] { return state->pending == 0 || pool->queued > 0; });
+        }
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> guard(state->lock);
+        std::swap(error, state->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+static std::mutex instance_lock;
+static std::shared_ptr<thread_pool> global_pool;
+static std::atomic<size_t> global_cutoff(4096);
+
+std::shared_ptr<thread_pool> thread_pool::instance() {
+    std::lock_guard<std::mutex> guard(instance_lock);
+    return global_pool;
+}
+
+void thread_pool::set_threads(size_t threads) {
+    std::shared_ptr<thread_pool> pool;
+    if (threads > 1) {
+        pool = std::make_shared<thread_pool>(threads);
+    }
+    std::lock_guard<std::mutex> guard(instance_lock);
+    std::swap(global_pool, pool);
+}
+
+size_t thread_pool::threads() {
+    std::lock_guard<std::mutex> guard(instance_lock);
+    return global_pool ? global_pool->size() : 1;
+}
+
+size_t thread_pool::parallel_cutoff() {
+    return global_cutoff;
+}
+
+void thread_pool::set_parallel_cutoff(size_t limbs) {
+    global_cutoff = limbs;
+}
+
+void parallel_for(thread_pool *pool, size_t begin, size_t end, size_t grain,
+                  std::function<void(size_t, size_t)> const &f) {
+    if (grain == 0) {
+        grain = 1;
+    }
+    if (pool == nullptr || end - begin <= grain) {
+        f(begin, end);
+        return;
+    }
+    size_t pieces = std::min(pool->size() * 4, (end - begin + grain - 1) / grain);
+    size_t step = (end - begin + pieces - 1) / pieces;
+    thread_pool::task_group group(pool);
+    for (size_t from = begin + step; from < end; from += step) {
+        size_t to = std::min(end, from + step);
+        group.spawn([&f, from, to] { f(from, to); });
+    }
+    f(begin, std::min(end, begin + step));
+    group.wait();
+}
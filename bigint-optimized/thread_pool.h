@@ -0,0 +1,100 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool: every worker owns a deque, takes its own newest task
+// and steals the oldest task of somebody else when it runs out of work.
+// A thread waiting for a task_group runs pending tasks and only sleeps when
+// there are none, so nested fork-join never deadlocks.
+struct thread_pool {
+    explicit thread_pool(size_t threads);
+
+    ~thread_pool();
+
+    thread_pool(thread_pool const &) = delete;
+
+    thread_pool &operator=(thread_pool const &) = delete;
+
+    // number of threads taking part in the work, the waiting caller included
+    size_t size() const {
+        return workers.size() + 1;
+    }
+
+    struct group_state;
+
+    struct task_group {
+        explicit task_group(thread_pool *pool);
+
+        ~task_group();
+
+        task_group(task_group const &) = delete;
+
+        task_group &operator=(task_group const &) = delete;
+
+        // runs f inline when there is no pool
+        void spawn(std::function<void()> f);
+
+        // rethrows the first exception thrown by a task of the group
+        void wait();
+
+    private:
+        thread_pool *pool;
+        std::shared_ptr<group_state> state;
+    };
+
+    // pool used by big_integer algorithms, null when they run serially
+    static std::shared_ptr<thread_pool> instance();
+
+    // 0 and 1 make big_integer serial again, operations already running finish on the old pool
+    static void set_threads(size_t threads);
+
+    static size_t threads();
+
+    // operands below this many limbs are never split across threads
+    static size_t parallel_cutoff();
+
+    static void set_parallel_cutoff(size_t limbs);
+
+private:
+    struct task {
+        std::function<void()> f;
+        std::shared_ptr<group_state> group;
+    };
+
+    struct queue {
+        std::mutex lock;
+        std::deque<task> tasks;
+    };
+
+    size_t current_queue() const;
+
+    void push(task t);
+
+    bool try_run(size_t self);
+
+    void work(size_t self);
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    std::atomic<size_t> queued;
+    std::atomic<size_t> next_queue;
+    bool stopping;
+};
+
+// calls f(from, to) on pieces of [begin, end) no shorter than grain, in parallel when a pool is given
+void parallel_for(thread_pool *pool, size_t begin, size_t end, size_t grain,
+                  std::function<void(size_t, size_t)> const &f);
+
+#endif //THREAD_POOL_H
@@ -7,20 +7,27 @@
 
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include "big_integer_stats.h"
 
+// the count is atomic so copies of one value may be made and dropped on several threads at once
 struct dynamic_buffer {
-    size_t ref_cnt;
+    std::atomic<size_t> ref_cnt;
     std::vector<uint32_t> data;
 
-    dynamic_buffer(std::vector<uint32_t> data) : ref_cnt(1), data(data) {}
+    dynamic_buffer(std::vector<uint32_t> data) : ref_cnt(1), data(data) {
+        BIGINT_STATS_COUNT(ALLOCATIONS);
+    }
 
     size_t use_count() {
         return ref_cnt;
     }
 
-    ~dynamic_buffer() = default;
+    ~dynamic_buffer() {
+        BIGINT_STATS_COUNT(FREES);
+    }
 };
 
 
@@ -44,6 +51,7 @@ struct uint_vector {
         } else {
             dynamic_data = other.dynamic_data;
             dynamic_data->ref_cnt++;
+            BIGINT_STATS_COUNT(SHARED_COPIES);
         }
     }
 
@@ -53,8 +61,7 @@ struct uint_vector {
 
     void del_data() {
         if (!is_small()) {
-            dynamic_data->ref_cnt--;
-            if (dynamic_data->ref_cnt == 0) {
+            if (--dynamic_data->ref_cnt == 0) {
                 delete dynamic_data;
             }
         }
@@ -69,6 +76,7 @@ struct uint_vector {
         } else {
             dynamic_data = other.dynamic_data;
             dynamic_data->ref_cnt++;
+            BIGINT_STATS_COUNT(SHARED_COPIES);
         }
         return *this;
     }
@@ -99,6 +107,9 @@ struct uint_vector {
             }
         } else {
             unshare();
+            if (dynamic_data->data.size() == dynamic_data->data.capacity()) {
+                BIGINT_STATS_COUNT(REALLOCATIONS);
+            }
             dynamic_data->data.push_back(x);
             size_++;
         }
@@ -129,6 +140,21 @@ struct uint_vector {
         return dynamic_data->data[ind];
     }
 
+    uint32_t *data() {
+        if (is_small()) {
+            return static_data;
+        }
+        unshare();
+        return dynamic_data->data.data();
+    }
+
+    uint32_t const *data() const {
+        if (is_small()) {
+            return static_data;
+        }
+        return dynamic_data->data.data();
+    }
+
     uint32_t back() const {
         if (is_small()) {
             return static_data[size_ - 1];
@@ -157,6 +183,25 @@ struct uint_vector {
         }
     }
 
+    // keeps an unshared buffer, so repeated writes of similar sizes do not allocate
+    void resize(size_t size) {
+        if (is_small()) {
+            if (size <= MAX_STATIC_SIZE) {
+                std::fill(static_data + std::min(size, size_), static_data + size, 0);
+                size_ = size;
+                return;
+            }
+            std::vector<uint32_t> tmp(static_data, static_data + size_);
+            tmp.resize(size, 0);
+            dynamic_data = new dynamic_buffer(tmp);
+            small = false;
+        } else {
+            unshare();
+            dynamic_data->data.resize(size, 0);
+        }
+        size_ = size;
+    }
+
     void swap(uint_vector &other) {
         uint_vector tmp(other);
         other = *this;
@@ -185,8 +230,11 @@ private:
 
     void unshare() {
         if (dynamic_data->use_count() != 1) {
-            dynamic_data->ref_cnt--;
-            dynamic_data = new dynamic_buffer(dynamic_data->data);
+            // copy before letting go, the other owners may drop theirs meanwhile
+            dynamic_buffer *copy = new dynamic_buffer(dynamic_data->data);
+            del_data();
+            dynamic_data = copy;
+            BIGINT_STATS_COUNT(UNSHARES);
         }
     }
 };